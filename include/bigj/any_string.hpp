@@ -0,0 +1,155 @@
+#pragma once
+
+#include "any_string_view.hpp"
+#include "basic_string.hpp"
+#include "unicode/encoding/utf8.hpp"
+#include "unicode/encoding/utf16.hpp"
+#include "unicode/encoding/utf32.hpp"
+#include "unicode/encoding_id.hpp"
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <cstddef>
+
+namespace bigj {
+
+// A string whose encoding is only known at runtime, holding the typed
+// string of that encoding. Strings of any encoding are adopted as they are,
+// sharing their blocks, and are only transcoded when asked to.
+struct any_string {
+
+    using value_type = unicode::code_point;
+    using size_type = size_t;
+
+    any_string() noexcept = default;
+
+    template<unicode::encoding E, size_t N>
+    any_string(basic_string<E, N> str)
+        : m_string {std::in_place_type<basic_string<E>>, std::move(str)} {}
+
+    // Copies sv, keeping its encoding.
+    explicit any_string(any_string_view sv)
+        : m_string {sv.visit([]<typename E>(basic_string_view<E> typed) -> string_type {
+            return basic_string<E> {typed};
+        })} {}
+
+    // Transcodes sv to the encoding id.
+    any_string(any_string_view sv, unicode::encoding_id id)
+        : m_string {unicode::detail::visit_encoding(id, [&]<typename E>(std::type_identity<E>) -> string_type {
+            return sv.transcode<E>();
+        })} {}
+
+    // Validates and copies bytes as the code units of the encoding id.
+    any_string(std::span<const std::byte> bytes, unicode::encoding_id id)
+        : any_string {any_string_view {bytes, id}} {}
+
+    operator any_string_view() const noexcept {
+        return std::visit([](const auto& str) { return any_string_view {str}; }, m_string);
+    }
+
+    // Encoding
+
+    auto encoding() const noexcept -> unicode::encoding_id {
+        return unicode::encoding_ids[m_string.index()];
+    }
+
+    template<unicode::encoding E>
+    auto holds() const noexcept -> bool {
+        return std::holds_alternative<basic_string<E>>(m_string);
+    }
+
+    // Returns the typed string, throwing std::bad_variant_access if it has
+    // another encoding.
+    template<unicode::encoding E>
+    auto get() const -> const basic_string<E>& {
+        return std::get<basic_string<E>>(m_string);
+    }
+
+    // Calls f with the typed string.
+    template<typename F>
+    auto visit(F&& f) const -> decltype(auto) {
+        return std::visit(std::forward<F>(f), m_string);
+    }
+
+    auto bytes() const noexcept -> std::span<const std::byte> {
+        return visit([](const auto& str) {
+            auto units = str.code_units();
+            return std::as_bytes(std::span {units.data(), units.size()});
+        });
+    }
+
+    // Capacity
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return visit([](const auto& str) { return str.empty(); });
+    }
+
+    // Cached by large strings, as for typed strings.
+    auto length() const noexcept -> size_type {
+        return visit([](const auto& str) { return str.length(); });
+    }
+
+    auto size() const noexcept -> size_type {
+        return length();
+    }
+
+    // Search
+
+    auto find(any_string_view str) const -> std::optional<size_type> {
+        return any_string_view {*this}.find(str);
+    }
+
+    auto contains(any_string_view str) const -> bool {
+        return any_string_view {*this}.contains(str);
+    }
+
+    auto starts_with(any_string_view str) const -> bool {
+        return any_string_view {*this}.starts_with(str);
+    }
+
+    auto ends_with(any_string_view str) const -> bool {
+        return any_string_view {*this}.ends_with(str);
+    }
+
+    // Conversions
+
+    // Shares the block of the string if it already has encoding E.
+    template<unicode::encoding E>
+    auto transcode() const -> basic_string<E> {
+        return visit([](const auto& str) { return basic_string<E> {str}; });
+    }
+
+    auto transcode(unicode::encoding_id id) const -> any_string {
+        return id == encoding() ? *this : any_string {*this, id};
+    }
+
+  private:
+    using string_type = std::variant<
+        basic_string<unicode::utf8>,
+        basic_string<unicode::utf16le>,
+        basic_string<unicode::utf16be>,
+        basic_string<unicode::utf32le>,
+        basic_string<unicode::utf32be>
+    >;
+
+    string_type m_string;
+};
+
+} // namespace bigj
+
+namespace std {
+
+template<>
+struct hash<bigj::any_string> {
+
+    auto operator()(const bigj::any_string& str) const noexcept -> size_t {
+        return hash<bigj::any_string_view> {}(str);
+    }
+};
+
+} // namespace std
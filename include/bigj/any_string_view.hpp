@@ -0,0 +1,210 @@
+#pragma once
+
+#include "basic_string.hpp"
+#include "basic_string_view.hpp"
+#include "unicode/encoding/utf8.hpp"
+#include "unicode/encoding/utf16.hpp"
+#include "unicode/encoding/utf32.hpp"
+#include "unicode/encoding_id.hpp"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bigj {
+
+// A string view whose encoding is only known at runtime. Each operation
+// dispatches once on the encoding and then runs the kernels of the typed
+// view, so strings that are only passed along are never transcoded.
+struct any_string_view {
+
+    using value_type = unicode::code_point;
+    using size_type = size_t;
+
+    constexpr any_string_view() noexcept = default;
+
+    template<unicode::detail::string_like S>
+    constexpr any_string_view(const S& str) noexcept
+        : m_view {unicode::detail::as_view(str)} {}
+
+    // Validates bytes as the code units of the encoding id, to whose code
+    // units they must be aligned.
+    any_string_view(std::span<const std::byte> bytes, unicode::encoding_id id)
+        : m_view {unicode::detail::visit_encoding(id, [&]<typename E>(std::type_identity<E>) -> view_type {
+            using code_unit = typename E::code_unit;
+
+            if (
+                bytes.size() % sizeof(code_unit) != 0
+                || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(code_unit) != 0
+            ) [[unlikely]] {
+                throw std::invalid_argument {"bytes are not code units of the encoding"};
+            }
+
+            auto begin = reinterpret_cast<const code_unit*>(bytes.data());
+            return basic_string_view<E> {begin, begin + bytes.size() / sizeof(code_unit)};
+        })} {}
+
+    // Encoding
+
+    auto encoding() const noexcept -> unicode::encoding_id {
+        return unicode::encoding_ids[m_view.index()];
+    }
+
+    template<unicode::encoding E>
+    auto holds() const noexcept -> bool {
+        return std::holds_alternative<basic_string_view<E>>(m_view);
+    }
+
+    // Returns the typed view, throwing std::bad_variant_access if it has
+    // another encoding.
+    template<unicode::encoding E>
+    auto get() const -> basic_string_view<E> {
+        return std::get<basic_string_view<E>>(m_view);
+    }
+
+    // Calls f with the typed view.
+    template<typename F>
+    auto visit(F&& f) const -> decltype(auto) {
+        return std::visit(std::forward<F>(f), m_view);
+    }
+
+    auto bytes() const noexcept -> std::span<const std::byte> {
+        return visit([](auto sv) {
+            auto units = sv.code_units();
+            return std::as_bytes(std::span {units.data(), units.size()});
+        });
+    }
+
+    // Capacity
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return bytes().empty();
+    }
+
+    auto length() const noexcept -> size_type {
+        return visit([](auto sv) { return sv.length(); });
+    }
+
+    auto size() const noexcept -> size_type {
+        return length();
+    }
+
+    // Search
+
+    // Strings of another encoding are transcoded to the one of this string
+    // before searching it, which is never transcoded.
+
+    // Returns the position in code units of the first occurrence of str.
+    auto find(any_string_view str) const -> std::optional<size_type> {
+        return visit([&]<typename E>(basic_string_view<E> sv) {
+            return with_encoding<E>(str, [&](basic_string_view<E> needle) -> std::optional<size_type> {
+                if (needle.empty()) return 0;
+
+                auto match = sv.find(needle);
+
+                if (match == sv.end()) {
+                    return std::nullopt;
+                } else {
+                    return static_cast<size_type>(match.address() - sv.code_units().data());
+                }
+            });
+        });
+    }
+
+    auto contains(any_string_view str) const -> bool {
+        return find(str).has_value();
+    }
+
+    auto starts_with(any_string_view str) const -> bool {
+        return visit([&]<typename E>(basic_string_view<E> sv) {
+            return with_encoding<E>(str, [&](basic_string_view<E> prefix) { return sv.starts_with(prefix); });
+        });
+    }
+
+    auto ends_with(any_string_view str) const -> bool {
+        return visit([&]<typename E>(basic_string_view<E> sv) {
+            return with_encoding<E>(str, [&](basic_string_view<E> suffix) { return sv.ends_with(suffix); });
+        });
+    }
+
+    // Conversions
+
+    template<unicode::encoding E>
+    auto transcode() const -> basic_string<E> {
+        return visit([](auto sv) { return basic_string<E> {sv}; });
+    }
+
+  private:
+    // The alternatives follow encoding_ids, so that the index of a view is
+    // the position of its encoding there.
+    using view_type = std::variant<
+        basic_string_view<unicode::utf8>,
+        basic_string_view<unicode::utf16le>,
+        basic_string_view<unicode::utf16be>,
+        basic_string_view<unicode::utf32le>,
+        basic_string_view<unicode::utf32be>
+    >;
+
+    static_assert(std::ranges::equal(unicode::encoding_ids, std::array {
+        unicode::encoding_id_of<unicode::utf8>,
+        unicode::encoding_id_of<unicode::utf16le>,
+        unicode::encoding_id_of<unicode::utf16be>,
+        unicode::encoding_id_of<unicode::utf32le>,
+        unicode::encoding_id_of<unicode::utf32be>,
+    }));
+
+    // Calls f with str in encoding E, transcoding it only if it has another
+    // encoding.
+    template<unicode::encoding E, typename F>
+    static auto with_encoding(any_string_view str, F&& f) -> std::invoke_result_t<F, basic_string_view<E>> {
+        if (auto sv = std::get_if<basic_string_view<E>>(&str.m_view)) {
+            return f(*sv);
+        } else {
+            auto transcoded = str.transcode<E>();
+            return f(basic_string_view<E> {transcoded});
+        }
+    }
+
+    view_type m_view;
+};
+
+// Strings compare as their code points, dispatching once on each encoding.
+
+inline auto operator==(any_string_view lhs, any_string_view rhs) noexcept -> bool {
+    return lhs.visit([&](auto l) {
+        return rhs.visit([&](auto r) { return l == r; });
+    });
+}
+
+inline auto operator<=>(any_string_view lhs, any_string_view rhs) noexcept -> std::strong_ordering {
+    return lhs.visit([&](auto l) {
+        return rhs.visit([&](auto r) { return l <=> r; });
+    });
+}
+
+} // namespace bigj
+
+namespace std {
+
+// Equal to the hash of the typed view, whatever the encoding.
+template<>
+struct hash<bigj::any_string_view> {
+
+    auto operator()(bigj::any_string_view sv) const noexcept -> size_t {
+        return sv.visit([]<typename E>(bigj::basic_string_view<E> typed) {
+            return hash<bigj::basic_string_view<E>> {}(typed);
+        });
+    }
+};
+
+} // namespace std
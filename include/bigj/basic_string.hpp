@@ -3,25 +3,93 @@
 #include "basic_string_view.hpp"
 #include "unicode/config.hpp"
 #include "unicode/detail/endian.hpp"
+#include "unicode/detail/transcode.hpp"
+#include "unicode/statistics.hpp"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <new>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 namespace bigj {
+namespace unicode {
+namespace detail {
+
+template<encoding E, auto S>
+struct string_literal;
+
+// Header shared by all strings referencing the same buffer, whatever their
+// inline capacity. Buffers allocated by the string directly follow their
+// header and have no release function, adopted buffers are released through
+// theirs. The capacity counts the code units that fit in the buffer,
+// excluding the null terminator.
+template<typename Unit>
+struct string_block {
+    std::atomic_size_t refs;
+    size_t capacity;
+    Unit* data;
+    void (*release)(const Unit* data, size_t size, void* context);
+    void* context;
+};
+
+// Layouts of strings on the heap or in static storage. Both end in a tag
+// whose last byte in memory overlaps the size of small strings. Wide strings
+// may be padded to make room for longer small strings, compact ones find
+// their code units through the header and leave out the cached length.
+
+template<typename Pointer, typename Header, size_t Padding>
+struct wide_large_str {
+    Pointer begin;
+    Pointer end;
+    Header* header;
+    std::array<std::byte, Padding> padding;
+    mutable size_t tag;
+};
+
+template<typename Pointer, typename Header>
+struct wide_large_str<Pointer, Header, 0> {
+    Pointer begin;
+    Pointer end;
+    Header* header;
+    mutable size_t tag;
+};
+
+template<typename Pointer, typename Header>
+struct compact_large_str {
+    union {
+        Header* header;
+        Pointer data;
+    };
+    uint32_t offset;
+    mutable uint32_t tag;
+};
 
-template<unicode::encoding E>
+} // namespace detail
+} // namespace unicode
+
+// Size of the smallest strings, which hold up to 2^30 - 1 code units and
+// recount their length every time it is asked for.
+inline constexpr auto compact_inline_bytes = sizeof(void*) + 2 * sizeof(uint32_t);
+
+// Strings with fewer code units than fit in InlineBytes are stored inline,
+// longer ones on the heap.
+template<unicode::encoding E, size_t InlineBytes = unicode::config::inline_bytes>
     requires unicode::detail::big_or_little<std::endian::native>
 struct basic_string {
 
+    using encoding_type = E;
     using code_unit = typename E::code_unit;
     using value_type = unicode::code_point;
     using const_pointer = const code_unit*;
@@ -32,6 +100,7 @@ struct basic_string {
     using reverse_iterator = const_reverse_iterator;
     using size_type = size_t;
     using difference_type = ptrdiff_t;
+    using release_function = void (*)(const_pointer data, size_type size, void* context);
 
     constexpr basic_string() noexcept {
         small_size(0);
@@ -56,20 +125,14 @@ struct basic_string {
 
     template<unicode::encoding F>
     basic_string(basic_string_view<F> sv) {
-        auto size = size_type {0};
-
-        for (auto cp : sv.code_points()) {
-            size += E::encoded_size(cp);
-        }
+        auto units = sv.code_units();
+        auto it = units.begin();
+        auto size = unicode::detail::transcoded_size<E, F>(units.begin(), units.end());
 
         auto data = init(size);
-        auto end = data + size;
+        auto end = unicode::detail::transcode_block<E, F>(it, units.end(), data, data + size);
 
-        for (auto cp : sv.code_points()) {
-            data = E::encode(cp, data);
-        }
-
-        assert(data == end);
+        assert(end == data + size);
     }
 
     template<unicode::encoding F>
@@ -77,13 +140,47 @@ struct basic_string {
     basic_string(basic_string_view<F> sv)
         : basic_string {sv.begin(), sv.end()} {}
 
-    template<unicode::encoding F>
-    basic_string(const basic_string<F>& other)
+    template<unicode::encoding F, size_t N>
+    basic_string(const basic_string<F, N>& other)
         : basic_string {static_cast<basic_string_view<F>>(other)} {}
 
+    // Strings of the same encoding share their blocks, whatever their inline
+    // capacity, unless a compact string could not address the code units.
+    template<unicode::encoding F, size_t N>
+        requires std::same_as<E, F>
+    basic_string(const basic_string<F, N>& other) {
+        auto units = other.code_units();
+        auto size = static_cast<size_type>(units.size());
+        auto header = other.is_large() ? other.large_header() : nullptr;
+
+        auto shareable = other.is_large() && size > max_small_capacity && size <= max_size()
+            && is_addressable(header, units.end());
+
+        if (shareable) {
+            set_large(
+                header,
+                const_cast<pointer>(units.begin()),
+                const_cast<pointer>(units.end()),
+                std::min(other.cached_length(), max_length)
+            );
+
+            if (header) {
+                header->refs++;
+                unicode::detail::record(unicode::detail::statistic::shared_references);
+            }
+        } else {
+            auto data = init(size);
+            std::copy(units.begin(), units.end(), data);
+        }
+    }
+
     basic_string(const basic_string& other) noexcept {
         m_bytes = other.m_bytes;
-        if (is_large()) (*m_large.refs)++;
+
+        if (is_counted()) {
+            large_header()->refs++;
+            unicode::detail::record(unicode::detail::statistic::shared_references);
+        }
     }
 
     constexpr basic_string(basic_string&& other) noexcept {
@@ -100,11 +197,53 @@ struct basic_string {
         destroy();
     }
 
+    // Takes ownership of an external buffer of valid code units without
+    // copying it. Copies and substrings share the buffer, release is called
+    // with the buffer and context once the last of them is destroyed. Short
+    // buffers are copied and released right away instead. Release must not be
+    // null. If an exception is thrown the buffer is not adopted and release is
+    // not called.
+    static auto adopt(
+        const_pointer begin,
+        const_pointer end,
+        release_function release,
+        void* context = nullptr
+    ) -> basic_string {
+        assert(begin <= end);
+
+        if (release == nullptr) [[unlikely]] {
+            throw std::invalid_argument {"release function must not be null"};
+        }
+
+        unicode::detail::validate_string<E>(begin, end);
+
+        auto str = basic_string {};
+        auto size = static_cast<size_type>(end - begin);
+
+        if (size <= max_small_capacity) {
+            auto data = str.init(size);
+            std::copy(begin, end, data);
+            release(begin, size, context);
+        } else if (size <= str.max_size()) {
+            auto ptr = operator new(sizeof(block_header));
+
+            auto header = new(ptr) block_header {
+                {1}, size, const_cast<pointer>(begin), release, context
+            };
+
+            str.set_large(header, const_cast<pointer>(begin), const_cast<pointer>(end));
+        } else [[unlikely]] {
+            throw std::length_error {"string is too long"};
+        }
+
+        return str;
+    }
+
     // Iterators
 
     constexpr auto begin() const noexcept -> const_iterator {
         if (is_large()) {
-            return const_iterator {m_large.begin};
+            return const_iterator {large_begin()};
         } else {
             return const_iterator {m_small.data()};
         }
@@ -112,7 +251,7 @@ struct basic_string {
 
     constexpr auto end() const noexcept -> const_iterator {
         if (is_large()) {
-            return const_iterator {m_large.end};
+            return const_iterator {large_end()};
         } else {
             return const_iterator {m_small.data() + small_size()};
         }
@@ -120,7 +259,7 @@ struct basic_string {
 
     constexpr auto rbegin() const noexcept -> const_reverse_iterator {
         if (is_large()) {
-            return const_reverse_iterator {m_large.end, m_large.begin};
+            return const_reverse_iterator {large_end(), large_begin()};
         } else {
             return const_reverse_iterator {m_small.data() + small_size(), m_small.data()};
         }
@@ -128,7 +267,7 @@ struct basic_string {
 
     constexpr auto rend() const noexcept -> const_reverse_iterator {
         if (is_large()) {
-            return const_reverse_iterator {m_large.begin, m_large.begin};
+            return const_reverse_iterator {large_begin(), large_begin()};
         } else {
             return const_reverse_iterator {m_small.data(), m_small.data()};
         }
@@ -166,19 +305,41 @@ struct basic_string {
 
     constexpr auto code_units() const noexcept -> std::ranges::subrange<const_pointer> {
         if (is_large()) {
-            return {m_large.begin, m_large.end};
+            return {large_begin(), large_end()};
         } else {
             return {m_small.data(), m_small.data() + small_size()};
         }
     }
 
-    constexpr auto c_str() const noexcept -> const_pointer
+    auto decode_blocks(std::span<value_type> buffer) const -> unicode::decoded_blocks<E> {
+        return basic_string_view<E> {*this}.decode_blocks(buffer);
+    }
+
+    // Strings sharing a heap block are terminated lazily. A string that
+    // does not end where a terminator is, and cannot write one in place, is
+    // moved to a block of its own, which invalidates its iterators. Like the
+    // length cache, this must not race with other uses of the same string.
+    auto c_str() const -> const_pointer
         requires unicode::config::null_terminators
     {
-        if (is_large()) {
-            return m_large.begin;
+        if (is_counted()) {
+            auto header = large_header();
+
+            if (header->release == nullptr) {
+                auto terminator = std::atomic_ref<code_unit> {*large_end()};
+
+                if (terminator.load(std::memory_order_relaxed) == null_terminator) {
+                    return large_begin();
+                } else if (is_unique()) {
+                    terminator.store(null_terminator, std::memory_order_relaxed);
+                    return large_begin();
+                }
+            }
+
+            move_to_own_block();
+            return large_begin();
         } else {
-            return m_small.data();
+            return code_units().begin();
         }
     }
 
@@ -194,16 +355,22 @@ struct basic_string {
     // Capacity
 
     [[nodiscard]] constexpr auto empty() const noexcept -> bool {
-        return is_empty();
+        if (is_large()) {
+            return large_begin() == large_end();
+        } else {
+            return is_empty();
+        }
     }
 
     auto length() const noexcept -> size_type {
         if (is_large()) {
-            if (m_large.length()) {
-                return m_large.length();
+            if (auto cached = cached_length()) {
+                unicode::detail::record(unicode::detail::statistic::length_cache_hits);
+                return cached;
             } else {
-                auto new_length = std::distance(begin(), end());
-                m_large.length(new_length);
+                unicode::detail::record(unicode::detail::statistic::length_cache_misses);
+                auto new_length = static_cast<size_type>(std::distance(begin(), end()));
+                cache_length(new_length);
                 return new_length;
             }
         } else {
@@ -217,11 +384,74 @@ struct basic_string {
 
     constexpr auto max_size() const noexcept -> size_type {
         constexpr auto max_bytes = std::numeric_limits<size_type>::max();
-        constexpr auto max_str_bytes = max_bytes - sizeof(ref_count);
+        constexpr auto max_str_bytes = max_bytes - block_overhead;
         constexpr auto max_code_units = max_str_bytes / sizeof(code_unit);
         return std::min(max_code_units, max_length);
     }
 
+    auto capacity() const noexcept -> size_type {
+        if (is_unique()) {
+            return block_end() - large_begin();
+        } else if (is_large()) {
+            return large_end() - large_begin();
+        } else {
+            return max_small_capacity;
+        }
+    }
+
+    // Number of bytes past the end of the code units that may be read
+    // without being part of the string. Heap blocks allocated by the string
+    // guarantee at least block_padding bytes.
+    auto readable_padding() const noexcept -> size_type {
+        if (is_counted()) {
+            if (large_header()->release == nullptr) {
+                auto terminator = unicode::config::null_terminators ? sizeof(code_unit) : 0;
+                auto spare = static_cast<size_type>(block_end() - large_end());
+                return sizeof(code_unit) * spare + terminator + unicode::config::block_padding;
+            } else {
+                return 0;
+            }
+        } else if (is_large()) {
+            return sizeof(code_unit);
+        } else {
+            return byte_count - sizeof(code_unit) * small_size();
+        }
+    }
+
+    // Number of bytes of the heap block this string keeps alive, which may be
+    // far more than it uses when it was created with substring().
+    auto shared_bytes() const noexcept -> size_type {
+        if (is_counted()) {
+            return sizeof(code_unit) * large_header()->capacity;
+        } else {
+            return 0;
+        }
+    }
+
+    // Fraction of the heap block this string keeps alive that it uses.
+    auto owned_fraction() const noexcept -> double {
+        if (is_counted() && large_header()->capacity) {
+            auto size = static_cast<double>(large_end() - large_begin());
+            return size / static_cast<double>(large_header()->capacity);
+        } else {
+            return 1.0;
+        }
+    }
+
+    auto reserve(size_type new_capacity) -> void {
+        if (new_capacity > capacity()) {
+            if (new_capacity > max_size()) [[unlikely]] {
+                throw std::length_error {"string is too long"};
+            }
+
+            auto units = code_units();
+            auto tmp = basic_string {};
+            auto data = tmp.init_large(units.size(), new_capacity);
+            std::copy(units.begin(), units.end(), data);
+            swap(tmp);
+        }
+    }
+
     // Modifiers
 
     auto clear() noexcept -> void {
@@ -232,16 +462,104 @@ struct basic_string {
         std::swap_ranges(m_bytes.begin(), m_bytes.end(), other.m_bytes.begin());
     }
 
-    auto remove_prefix(const_iterator new_begin) -> void {
+    // Copies the string into a block of its own size if it keeps a larger
+    // block alive.
+    auto compact() -> void {
+        if (is_counted() && static_cast<size_type>(large_end() - large_begin()) < large_header()->capacity) {
+            auto tmp = basic_string {std::move(*this)};
+            auto units = tmp.code_units();
+            auto data = init(units.size());
+            std::copy(units.begin(), units.end(), data);
+        }
+    }
+
+    auto append(basic_string_view<E> sv) -> basic_string& {
+        append_units(sv.m_begin, sv.m_end);
+        return *this;
+    }
+
+    template<unicode::encoding F>
+    auto append(basic_string_view<F> sv) -> basic_string& {
+        auto units = sv.code_units();
+        auto size = unicode::detail::transcoded_size<E, F>(units.begin(), units.end());
+
+        append_with(size, [&](pointer data) {
+            auto it = units.begin();
+            unicode::detail::transcode_block<E, F>(it, units.end(), data, data + size);
+        });
+
+        return *this;
+    }
+
+    template<unicode::encoding F, size_t N>
+    auto append(const basic_string<F, N>& other) -> basic_string& {
+        return append(static_cast<basic_string_view<F>>(other));
+    }
+
+    auto push_back(value_type cp) -> void {
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) [[unlikely]] {
+            throw unicode::parse_error {unicode::error_code::invalid_code_point};
+        }
+
+        auto units = std::array<code_unit, 4> {};
+        auto end = E::encode(cp, units.data());
+        append_units(units.data(), end);
+    }
+
+    auto replace(const_iterator first, const_iterator last, basic_string_view<E> sv)
+        -> basic_string&
+    {
+        auto first_ptr = first.address();
+        auto last_ptr = last.address();
+
+        validate_substring(first_ptr, last_ptr);
+
         auto begin_ptr = code_units().begin();
         auto end_ptr = code_units().end();
-        auto new_begin_ptr = new_begin.address();
+        auto removed = static_cast<size_type>(last_ptr - first_ptr);
+        auto inserted = static_cast<size_type>(sv.m_end - sv.m_begin);
+        auto size = static_cast<size_type>(end_ptr - begin_ptr) - removed + inserted;
+
+        auto aliased = sv.m_begin < end_ptr && sv.m_end > begin_ptr;
+        auto fits = is_unique()
+            ? size <= static_cast<size_type>(block_end() - begin_ptr)
+            : !is_large() && size <= max_small_capacity;
+
+        if (fits && !aliased) {
+            auto mutable_first = const_cast<pointer>(first_ptr);
+            auto mutable_last = const_cast<pointer>(last_ptr);
+            auto mutable_end = const_cast<pointer>(end_ptr);
+
+            if (inserted <= removed) {
+                std::copy(mutable_last, mutable_end, mutable_first + inserted);
+            } else {
+                std::copy_backward(mutable_last, mutable_end, mutable_end + (inserted - removed));
+            }
+
+            std::copy(sv.m_begin, sv.m_end, mutable_first);
+            set_size(size);
+        } else {
+            auto tmp = basic_string {};
+            auto data = tmp.init(size);
+            data = std::copy(begin_ptr, first_ptr, data);
+            data = std::copy(sv.m_begin, sv.m_end, data);
+            std::copy(last_ptr, end_ptr, data);
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    auto remove_prefix(const_iterator new_begin) -> void {
+        auto begin_ptr = const_cast<pointer>(code_units().begin());
+        auto end_ptr = const_cast<pointer>(code_units().end());
+        auto new_begin_ptr = const_cast<pointer>(new_begin.address());
 
         if (new_begin_ptr >= begin_ptr && new_begin_ptr <= end_ptr) {
-            auto size = end_ptr - new_begin_ptr;
+            auto size = static_cast<size_type>(end_ptr - new_begin_ptr);
 
             if (size > max_small_capacity) {
-                m_large.begin = new_begin_ptr;
+                set_large_begin(new_begin_ptr);
             } else if (is_large()) {
                 auto tmp = basic_string {std::move(*this)};
                 auto data = init_small(size);
@@ -260,20 +578,20 @@ struct basic_string {
     }
 
     auto remove_suffix(const_iterator new_end) -> void {
-        auto begin_ptr = code_units().begin();
-        auto end_ptr = code_units().end();
-        auto new_end_ptr = new_end.address();
+        auto begin_ptr = const_cast<pointer>(code_units().begin());
+        auto end_ptr = const_cast<pointer>(code_units().end());
+        auto new_end_ptr = const_cast<pointer>(new_end.address());
 
         if (new_end_ptr >= begin_ptr && new_end_ptr <= end_ptr) {
-            auto size = new_end_ptr - begin_ptr;
+            auto size = static_cast<size_type>(new_end_ptr - begin_ptr);
 
             if (size > max_small_capacity) {
-                if constexpr (unicode::config::null_terminators) {
+                if (is_counted() || !needs_terminator(new_end_ptr)) {
+                    set_large_end(new_end_ptr);
+                } else {
                     auto tmp = basic_string {std::move(*this)};
                     auto data = init_large(size);
                     std::copy(begin_ptr, new_end_ptr, data);
-                } else {
-                    m_large.end = new_end_ptr;
                 }
             } else if (is_large()) {
                 auto tmp = basic_string {std::move(*this)};
@@ -302,24 +620,33 @@ struct basic_string {
         validate_substring(begin_ptr, end_ptr);
 
         auto substr = basic_string {};
-        auto size = end_ptr - begin_ptr;
+        auto size = static_cast<size_type>(end_ptr - begin_ptr);
 
         if (size > max_small_capacity) {
-            if constexpr (unicode::config::null_terminators) {
-                if (end_ptr != m_large.end) {
+            if (!is_counted() && needs_terminator(end_ptr)) {
+                auto data = substr.init_large(size);
+                std::copy(begin_ptr, end_ptr, data);
+                return substr;
+            }
+
+            if constexpr (unicode::config::min_shared_fraction > 0) {
+                auto capacity = is_counted() ? large_header()->capacity : size;
+
+                if (size < unicode::config::min_shared_fraction * capacity) {
                     auto data = substr.init_large(size);
                     std::copy(begin_ptr, end_ptr, data);
                     return substr;
                 }
             }
 
-            substr.m_large.begin = begin_ptr;
-            substr.m_large.end = end_ptr;
-            substr.m_large.refs = m_large.refs;
-            substr.m_large.length(0);
-            (*m_large.refs)++;
+            substr.set_large(large_header(), const_cast<pointer>(begin_ptr), const_cast<pointer>(end_ptr));
+
+            if (is_counted()) {
+                large_header()->refs++;
+                unicode::detail::record(unicode::detail::statistic::shared_references);
+            }
         } else {
-            auto data = substr.init_small(size);
+            auto data = substr.init(size);
             std::copy(begin_ptr, end_ptr, data);
         }
 
@@ -355,7 +682,66 @@ struct basic_string {
         return substr;
     }
 
+    // Search
+
+    auto find(basic_string_view<E> str) const noexcept -> const_iterator {
+        return basic_string_view<E> {*this}.find(str);
+    }
+
+    auto rfind(basic_string_view<E> str) const noexcept -> const_iterator {
+        return basic_string_view<E> {*this}.rfind(str);
+    }
+
+    auto contains(basic_string_view<E> str) const noexcept -> bool {
+        return basic_string_view<E> {*this}.contains(str);
+    }
+
+    auto find(value_type cp) const noexcept -> const_iterator {
+        return basic_string_view<E> {*this}.find(cp);
+    }
+
+    auto rfind(value_type cp) const noexcept -> const_iterator {
+        return basic_string_view<E> {*this}.rfind(cp);
+    }
+
+    auto contains(value_type cp) const noexcept -> bool {
+        return basic_string_view<E> {*this}.contains(cp);
+    }
+
+    auto count(value_type cp) const noexcept -> size_type {
+        return basic_string_view<E> {*this}.count(cp);
+    }
+
+    auto starts_with(basic_string_view<E> str) const noexcept -> bool {
+        return basic_string_view<E> {*this}.starts_with(str);
+    }
+
+    auto ends_with(basic_string_view<E> str) const noexcept -> bool {
+        return basic_string_view<E> {*this}.ends_with(str);
+    }
+
   private:
+    template<unicode::encoding, auto>
+    friend struct unicode::detail::string_literal;
+
+    template<unicode::encoding F, size_t N>
+        requires unicode::detail::big_or_little<std::endian::native>
+    friend struct basic_string;
+
+    // Wraps code units with static storage duration that are known to be
+    // valid and are followed by a null terminator, such as the ones of a
+    // string literal.
+    static auto from_static(const_pointer begin, const_pointer end, size_type length)
+        noexcept -> basic_string
+    {
+        auto str = basic_string {};
+
+        if (begin != end) {
+            str.set_large(nullptr, const_cast<pointer>(begin), const_cast<pointer>(end), length);
+        }
+
+        return str;
+    }
 
     constexpr auto validate_substring(const_pointer begin, const_pointer end)
         const -> void
@@ -372,12 +758,26 @@ struct basic_string {
         }
     }
 
-    using ref_count = std::atomic_size_t;
+    using block_header = unicode::detail::string_block<code_unit>;
+
+    static constexpr auto block_alignment = std::align_val_t {unicode::config::block_alignment};
+
+    // The header is padded so that the code units following it are aligned.
+    static constexpr auto header_size = (sizeof(block_header) + unicode::config::block_alignment - 1)
+        / unicode::config::block_alignment * unicode::config::block_alignment;
+
+    static constexpr auto block_overhead = header_size + unicode::config::block_padding;
+
+    static_assert(std::has_single_bit(unicode::config::block_alignment));
+    static_assert(unicode::config::block_alignment >= alignof(block_header));
 
     static constexpr auto null_terminator = (code_unit) 0;
 
     auto init(size_type size) -> pointer {
+        unicode::detail::record_new_string(sizeof(code_unit) * size);
+
         if (size <= max_small_capacity) {
+            unicode::detail::record(unicode::detail::statistic::small_strings);
             return init_small(size);
         } else if (size <= max_size()) {
             return init_large(size);
@@ -399,73 +799,292 @@ struct basic_string {
     }
 
     auto init_large(size_type size) -> pointer {
-        assert(size <= max_size());
+        return init_large(size, size);
+    }
+
+    auto init_large(size_type size, size_type capacity) -> pointer {
+        assert(size <= capacity && capacity <= max_size());
 
-        auto code_unit_count = size;
+        auto code_unit_count = capacity;
 
         if constexpr (unicode::config::null_terminators) {
             code_unit_count += 1;
         }
 
-        auto allocation_size = sizeof(ref_count) + sizeof(code_unit) * code_unit_count;
-        auto ptr = operator new(allocation_size);
-        auto str_ptr = reinterpret_cast<pointer>(
-            static_cast<std::byte*>(ptr) + sizeof(ref_count));
+        auto data_size = sizeof(code_unit) * code_unit_count;
+        auto ptr = static_cast<std::byte*>(operator new(
+            block_overhead + data_size, block_alignment));
+
+        unicode::detail::record(unicode::detail::statistic::large_allocations);
+        unicode::detail::record(unicode::detail::statistic::allocated_bytes, block_overhead + data_size);
+
+        std::fill_n(ptr + header_size + data_size, unicode::config::block_padding, std::byte {0});
 
-        m_large.refs = new(ptr) ref_count {1};
-        m_large.begin = str_ptr;
-        m_large.end = m_large.begin + size;
-        m_large.length(0);
+        auto header = new(ptr) block_header {
+            {1}, capacity, reinterpret_cast<pointer>(ptr + header_size), nullptr, nullptr
+        };
+
+        set_large(header, header->data, header->data + size);
 
         if constexpr (unicode::config::null_terminators) {
-            *m_large.end = null_terminator;
+            *(header->data + size) = null_terminator;
         }
 
-        return m_large.begin;
+        return header->data;
     }
 
     auto destroy() noexcept -> void {
-        if (is_large() && (*m_large.refs)-- == 1) {
-            m_large.refs->~ref_count();
-            operator delete(static_cast<void*>(m_large.refs));
+        if (is_counted()) {
+            unicode::detail::record(unicode::detail::statistic::released_references);
+        }
+
+        if (is_counted() && large_header()->refs-- == 1) {
+            unicode::detail::record(unicode::detail::statistic::freed_blocks);
+
+            auto header = large_header();
+
+            if (header->release) {
+                header->release(header->data, header->capacity, header->context);
+                header->~block_header();
+                operator delete(static_cast<void*>(header));
+            } else {
+                header->~block_header();
+                operator delete(static_cast<void*>(header), block_alignment);
+            }
         }
         
         small_size(0);
     }
 
+    // End of the part of the block the string may grow into, which compact
+    // strings sharing the block of a wide one can only address the start of.
+    auto block_end() const noexcept -> pointer {
+        assert(is_counted());
+        auto capacity = large_header()->capacity;
+
+        if constexpr (is_compact) {
+            capacity = std::min<size_type>(capacity, std::numeric_limits<uint32_t>::max());
+        }
+
+        return large_header()->data + capacity;
+    }
+
+    // Static strings must stay null terminated, as there is no block to
+    // cache a terminated copy in.
+    static auto needs_terminator(const_pointer end) noexcept -> bool {
+        return unicode::config::null_terminators && *end != null_terminator;
+    }
+
+    // Copies the code units into a new block owned by this string alone,
+    // keeping the cached length.
+    auto move_to_own_block() const -> void {
+        auto units = code_units();
+        auto length = cached_length();
+
+        auto tmp = basic_string {};
+        auto data = tmp.init_large(units.size());
+        std::copy(units.begin(), units.end(), data);
+        std::swap_ranges(m_bytes.begin(), m_bytes.end(), tmp.m_bytes.begin());
+
+        cache_length(length);
+    }
+
+    // Large strings without a header point to immortal static storage,
+    // copying and destroying them leaves the reference count alone.
+    constexpr auto is_counted() const noexcept -> bool {
+        return is_large() && large_header() != nullptr;
+    }
+
+    // A block allocated by the string and referenced by no other string may
+    // be written to in place, every other string has to be copied before it
+    // is modified.
+    auto is_unique() const noexcept -> bool {
+        return is_counted()
+            && large_header()->release == nullptr
+            && large_header()->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    // Sets the size of a string that is modified in place and returns its
+    // new end.
+    auto set_size(size_type size) noexcept -> pointer {
+        if (is_large()) {
+            auto end = large_begin() + size;
+            set_large_end(end);
+
+            if constexpr (unicode::config::null_terminators) {
+                *end = null_terminator;
+            }
+
+            return end;
+        } else {
+            return init_small(size) + size;
+        }
+    }
+
+    // Appends count code units produced by write. The storage is grown in
+    // place when possible, otherwise the old block stays alive until write
+    // has run, so that it may read from this string.
+    template<typename F>
+    auto append_with(size_type count, F write) -> void {
+        auto units = code_units();
+        auto size = units.size();
+
+        if (count > max_size() - size) [[unlikely]] {
+            throw std::length_error {"string is too long"};
+        }
+
+        if (count <= capacity() - size && (is_unique() || !is_large())) {
+            write(set_size(size + count) - count);
+        } else {
+            auto new_capacity = std::max(size + count, std::min(2 * size, max_size()));
+
+            auto tmp = basic_string {};
+            auto data = tmp.init_large(size + count, new_capacity);
+            write(std::copy(units.begin(), units.end(), data));
+            swap(tmp);
+        }
+    }
+
+    auto append_units(const_pointer first, const_pointer last) -> void {
+        append_with(last - first, [&](pointer data) {
+            std::copy(first, last, data);
+        });
+    }
+
     constexpr auto abandon() noexcept -> void {
         small_size(0);
     }
 
     static constexpr auto is_big_endian = std::endian::native == std::endian::big;
     static constexpr auto byte_bits = std::numeric_limits<unsigned char>::digits;
-    static constexpr auto size_msb = (size_type) 1 << (byte_bits * sizeof(size_type) - 1);
     static constexpr auto byte_msb = (std::byte) 1 << (byte_bits - 1);
 
-    static constexpr auto max_length = size_msb - 1;
+    static constexpr auto wide_bytes = sizeof(unicode::detail::wide_large_str<pointer, block_header, 0>);
+    static constexpr auto is_compact = InlineBytes < wide_bytes;
+
+    using large_str = std::conditional_t<
+        is_compact,
+        unicode::detail::compact_large_str<pointer, block_header>,
+        unicode::detail::wide_large_str<pointer, block_header, is_compact ? 0 : InlineBytes - wide_bytes>
+    >;
+
+    using tag_type = decltype(large_str::tag);
 
-    struct large_str {
+    static constexpr auto tag_bits = byte_bits * sizeof(tag_type);
+    static constexpr auto tag_msb = (tag_type) 1 << (tag_bits - 1);
 
-        auto length() const noexcept -> size_type {
-            auto tmp = is_big_endian ? std::rotr(not_length, byte_bits) : not_length;
-            return tmp ^ size_msb;
+    // Wide strings keep their length in the tag, compact ones their size
+    // and whether they are static.
+    static constexpr auto static_bit = (tag_type) 1 << (tag_bits - 2);
+    static constexpr auto max_length = static_cast<size_type>(is_compact ? static_bit - 1 : tag_msb - 1);
+
+    static_assert(sizeof(large_str) == InlineBytes, "inline bytes must be compact_inline_bytes, "
+        "or at least four words and a multiple of the word size");
+
+    static constexpr auto byte_count = InlineBytes;
+    static constexpr auto code_unit_capacity = byte_count / sizeof(code_unit);
+    static constexpr auto max_small_capacity = static_cast<size_type>(code_unit_capacity - 1);
+
+    static_assert(max_small_capacity < 128, "the small size must fit in the tag byte");
+
+    // The tag is stored so that its most significant byte comes last in
+    // memory whatever the byte order, where it overlaps the small size.
+    constexpr auto tag() const noexcept -> tag_type {
+        return is_big_endian ? std::rotr(m_large.tag, byte_bits) : m_large.tag;
+    }
+
+    constexpr auto tag(tag_type value) const noexcept -> void {
+        m_large.tag = is_big_endian ? std::rotl(value, byte_bits) : value;
+    }
+
+    constexpr auto is_static() const noexcept -> bool {
+        return is_compact && (tag() & static_bit);
+    }
+
+    constexpr auto large_begin() const noexcept -> pointer {
+        if constexpr (is_compact) {
+            return is_static() ? m_large.data : m_large.header->data + m_large.offset;
+        } else {
+            return m_large.begin;
+        }
+    }
+
+    constexpr auto large_end() const noexcept -> pointer {
+        if constexpr (is_compact) {
+            return large_begin() + (tag() & max_length);
+        } else {
+            return m_large.end;
+        }
+    }
+
+    // Static strings have no header.
+    constexpr auto large_header() const noexcept -> block_header* {
+        if constexpr (is_compact) {
+            return is_static() ? nullptr : m_large.header;
+        } else {
+            return m_large.header;
+        }
+    }
+
+    // Zero if the length is unknown, which compact strings never cache.
+    constexpr auto cached_length() const noexcept -> size_type {
+        if constexpr (is_compact) {
+            return 0;
+        } else {
+            return tag() ^ tag_msb;
         }
+    }
 
-        auto length(size_type new_length) const noexcept -> void {
+    constexpr auto cache_length(size_type new_length) const noexcept -> void {
+        if constexpr (!is_compact) {
             assert(new_length <= max_length);
-            auto tmp = new_length | size_msb;
-            not_length = is_big_endian ? std::rotl(tmp, byte_bits) : tmp;
+            tag(new_length | tag_msb);
         }
+    }
 
-        pointer begin;
-        pointer end;
-        ref_count* refs;
-        mutable size_type not_length;
-    };
+    // Compact strings find their code units at a 32 bit offset into their
+    // block, so they may only share the start of blocks of another string
+    // type.
+    static auto is_addressable(const block_header* header, const_pointer end) noexcept -> bool {
+        if constexpr (is_compact) {
+            return !header || static_cast<size_type>(end - header->data) <= std::numeric_limits<uint32_t>::max();
+        } else {
+            return true;
+        }
+    }
 
-    static constexpr auto byte_count = offsetof(large_str, not_length) + sizeof(size_type);
-    static constexpr auto code_unit_capacity = byte_count / sizeof(code_unit);
-    static constexpr auto max_small_capacity = static_cast<size_type>(code_unit_capacity - 1);
+    constexpr auto set_large(block_header* header, pointer begin, pointer end, size_type length = 0)
+        noexcept -> void
+    {
+        if constexpr (is_compact) {
+            auto size = static_cast<tag_type>(end - begin);
+            assert(size <= max_length);
+
+            if (header) {
+                assert(is_addressable(header, end));
+                m_large.header = header;
+                m_large.offset = static_cast<uint32_t>(begin - header->data);
+                tag(size | tag_msb);
+            } else {
+                m_large.data = begin;
+                m_large.offset = 0;
+                tag(size | tag_msb | static_bit);
+            }
+        } else {
+            m_large.begin = begin;
+            m_large.end = end;
+            m_large.header = header;
+            cache_length(length);
+        }
+    }
+
+    constexpr auto set_large_begin(pointer begin) noexcept -> void {
+        set_large(large_header(), begin, large_end());
+    }
+
+    constexpr auto set_large_end(pointer end) noexcept -> void {
+        set_large(large_header(), large_begin(), end);
+    }
 
     constexpr auto is_empty() const noexcept -> bool {
         return static_cast<size_type>(m_bytes.back()) == max_small_capacity;
@@ -484,11 +1103,59 @@ struct basic_string {
         m_bytes.back() = static_cast<std::byte>(max_small_capacity - new_size);
     }
 
+    // Mutable so that c_str() may move the string to a block of its own.
     union {
-        std::array<std::byte, byte_count> m_bytes;
-        std::array<code_unit, code_unit_capacity> m_small;
-        large_str m_large;
+        mutable std::array<std::byte, byte_count> m_bytes;
+        mutable std::array<code_unit, code_unit_capacity> m_small;
+        mutable large_str m_large;
     };
 };
 
+namespace unicode {
+namespace detail {
+
+template<encoding E, size_t N>
+struct string_traits<basic_string<E, N>> {
+    using encoding_type = E;
+};
+
+} // namespace detail
+} // namespace unicode
+
+// Hash and equality functors accepting strings and string views of any
+// encoding, for lookups in unordered containers that do not construct a
+// temporary key.
+struct string_hash {
+
+    using is_transparent = void;
+
+    template<unicode::detail::string_like S>
+    auto operator()(const S& str) const noexcept -> size_t {
+        using sv_type = basic_string_view<unicode::detail::string_encoding_t<S>>;
+        return std::hash<sv_type> {}(str);
+    }
+};
+
+struct string_equal {
+
+    using is_transparent = void;
+
+    template<unicode::detail::string_like S, unicode::detail::string_like T>
+    auto operator()(const S& lhs, const T& rhs) const noexcept -> bool {
+        return lhs == rhs;
+    }
+};
+
 } // namespace bigj
+
+namespace std {
+
+template<bigj::unicode::encoding E, size_t N>
+struct hash<bigj::basic_string<E, N>> {
+
+    auto operator()(const bigj::basic_string<E, N>& str) const noexcept -> size_t {
+        return hash<bigj::basic_string_view<E>> {}(str);
+    }
+};
+
+} // namespace std
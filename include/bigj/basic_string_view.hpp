@@ -1,21 +1,39 @@
 #pragma once
 
+#include "unicode/detail/compare.hpp"
+#include "unicode/detail/endian.hpp"
+#include "unicode/detail/hash.hpp"
+#include "unicode/detail/search.hpp"
 #include "unicode/detail/validate_string.hpp"
+#include "unicode/decoded_blocks.hpp"
 #include "unicode/iterator.hpp"
 #include "unicode/reverse_iterator.hpp"
 
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 #include <cassert>
 
 namespace bigj {
+namespace unicode {
+namespace detail {
+
+template<encoding E, typename Offset>
+struct offset_iterator;
+
+} // namespace detail
+} // namespace unicode
 
 template<unicode::encoding E>
 struct basic_string_view {
 
+    using encoding_type = E;
     using code_unit = typename E::code_unit;
     using value_type = unicode::code_point;
     using const_pointer = const code_unit*;
@@ -102,6 +120,11 @@ struct basic_string_view {
         return std::ranges::subrange {m_begin, m_end};
     }
 
+    // Decodes the code points into buffer a block at a time.
+    auto decode_blocks(std::span<value_type> buffer) const -> unicode::decoded_blocks<E> {
+        return {m_begin, m_end, buffer};
+    }
+
     // Capacity
 
     [[nodiscard]] constexpr auto empty() const noexcept -> bool {
@@ -169,12 +192,161 @@ struct basic_string_view {
         }
     }
 
+    // Search
+
+    // Returns the start of the first occurrence of str, or end() if there
+    // is none.
+    auto find(basic_string_view str) const noexcept -> const_iterator {
+        auto match = unicode::detail::find_string<E>(m_begin, m_end, str.m_begin, str.m_end);
+        return match ? const_iterator {match} : end();
+    }
+
+    // Returns the start of the last occurrence of str, or end() if there is
+    // none.
+    auto rfind(basic_string_view str) const noexcept -> const_iterator {
+        auto match = unicode::detail::rfind_string<E>(m_begin, m_end, str.m_begin, str.m_end);
+        return match ? const_iterator {match} : end();
+    }
+
+    // The empty string is found at the start of any view, even one that has
+    // no code units to point to.
+    auto contains(basic_string_view str) const noexcept -> bool {
+        return str.m_begin == str.m_end
+            || unicode::detail::find_string<E>(m_begin, m_end, str.m_begin, str.m_end);
+    }
+
+    auto find(value_type cp) const noexcept -> const_iterator {
+        auto needle = unicode::detail::encoded_code_point<E> {cp};
+        auto match = unicode::detail::find_string<E>(m_begin, m_end, needle.begin(), needle.end());
+        return match && !needle.empty() ? const_iterator {match} : end();
+    }
+
+    auto rfind(value_type cp) const noexcept -> const_iterator {
+        auto needle = unicode::detail::encoded_code_point<E> {cp};
+        auto match = unicode::detail::rfind_string<E>(m_begin, m_end, needle.begin(), needle.end());
+        return match && !needle.empty() ? const_iterator {match} : end();
+    }
+
+    auto contains(value_type cp) const noexcept -> bool {
+        return find(cp) != end();
+    }
+
+    // Returns the number of times cp occurs.
+    auto count(value_type cp) const noexcept -> size_type {
+        auto needle = unicode::detail::encoded_code_point<E> {cp};
+
+        if (needle.empty()) {
+            return 0;
+        } else {
+            return unicode::detail::count_string<E>(m_begin, m_end, needle.begin(), needle.end());
+        }
+    }
+
+    auto starts_with(basic_string_view str) const noexcept -> bool {
+        auto size = str.m_end - str.m_begin;
+
+        return m_end - m_begin >= size && unicode::detail::equal_code_units<E>(
+            m_begin, m_begin + size, str.m_begin, str.m_end
+        );
+    }
+
+    auto ends_with(basic_string_view str) const noexcept -> bool {
+        auto size = str.m_end - str.m_begin;
+
+        return m_end - m_begin >= size && unicode::detail::equal_code_units<E>(
+            m_end - size, m_end, str.m_begin, str.m_end
+        );
+    }
+
   private:
-    template<unicode::encoding>
-    friend class basic_string;
+    template<unicode::encoding, size_t InlineBytes>
+        requires unicode::detail::big_or_little<std::endian::native>
+    friend struct basic_string;
+
+    template<unicode::encoding, typename>
+    friend struct unicode::detail::offset_iterator;
 
     const_pointer m_begin = nullptr;
     const_pointer m_end = nullptr;
 };
 
+namespace unicode {
+namespace detail {
+
+template<typename T>
+struct string_traits;
+
+template<encoding E>
+struct string_traits<basic_string_view<E>> {
+    using encoding_type = E;
+};
+
+template<typename T>
+concept string_like = requires {
+    typename string_traits<std::remove_cvref_t<T>>::encoding_type;
+};
+
+template<string_like T>
+using string_encoding_t = typename string_traits<std::remove_cvref_t<T>>::encoding_type;
+
+template<string_like T>
+constexpr auto as_view(const T& str) noexcept {
+    return static_cast<basic_string_view<string_encoding_t<T>>>(str);
+}
+
+} // namespace detail
+} // namespace unicode
+
+// Strings and string views compare equal when they hold the same code
+// points, and are ordered by code point otherwise, whatever their encodings.
+// Strings of the same encoding are compared a word of code units at a time.
+
+template<unicode::detail::string_like S, unicode::detail::string_like T>
+auto operator==(const S& lhs, const T& rhs) noexcept -> bool {
+    using E = unicode::detail::string_encoding_t<S>;
+    using F = unicode::detail::string_encoding_t<T>;
+
+    auto lhs_units = unicode::detail::as_view(lhs).code_units();
+    auto rhs_units = unicode::detail::as_view(rhs).code_units();
+
+    return unicode::detail::equal_code_points<E, F>(
+        lhs_units.begin(), lhs_units.end(),
+        rhs_units.begin(), rhs_units.end()
+    );
+}
+
+template<unicode::detail::string_like S, unicode::detail::string_like T>
+auto operator<=>(const S& lhs, const T& rhs) noexcept -> std::strong_ordering {
+    using E = unicode::detail::string_encoding_t<S>;
+    using F = unicode::detail::string_encoding_t<T>;
+
+    auto lhs_units = unicode::detail::as_view(lhs).code_units();
+    auto rhs_units = unicode::detail::as_view(rhs).code_units();
+
+    if constexpr (std::same_as<E, F>) {
+        return unicode::detail::compare_code_units<E>(
+            lhs_units.begin(), lhs_units.end(),
+            rhs_units.begin(), rhs_units.end()
+        );
+    } else {
+        return unicode::detail::compare_code_points<E, F>(
+            lhs_units.begin(), lhs_units.end(),
+            rhs_units.begin(), rhs_units.end()
+        );
+    }
+}
+
 } // namespace bigj
+
+namespace std {
+
+template<bigj::unicode::encoding E>
+struct hash<bigj::basic_string_view<E>> {
+
+    auto operator()(bigj::basic_string_view<E> sv) const noexcept -> size_t {
+        auto units = sv.code_units();
+        return static_cast<size_t>(bigj::unicode::detail::hash_code_points<E>(units.begin(), units.end()));
+    }
+};
+
+} // namespace std
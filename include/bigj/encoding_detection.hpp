@@ -0,0 +1,231 @@
+#pragma once
+
+#include "any_string_view.hpp"
+#include "unicode/detail/count.hpp"
+#include "unicode/detail/decode.hpp"
+#include "unicode/detail/validate_string.hpp"
+#include "unicode/encoding_id.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bigj {
+
+// The encoding of a byte buffer guessed by detect_encoding().
+struct encoding_detection {
+
+    unicode::encoding_id encoding = unicode::encoding_id::utf8;
+
+    // How strongly the bytes support the encoding, from 0 to 1.
+    double confidence = 0;
+
+    // Size in bytes of the byte order mark, or zero if there is none.
+    size_t bom_size = 0;
+};
+
+// A string validated by detect_string(), with the encoding it was detected in.
+struct detected_string {
+    any_string_view string;
+    encoding_detection detection;
+};
+
+namespace unicode {
+namespace detail {
+
+inline constexpr auto detection_prefix_size = size_t {4096};
+
+struct byte_order_mark {
+    encoding_id encoding;
+    std::array<uint8_t, 4> bytes;
+    size_t size;
+};
+
+// UTF-32LE comes before UTF-16LE, whose mark it starts with.
+inline constexpr auto byte_order_marks = std::array {
+    byte_order_mark {encoding_id::utf8, {0xEF, 0xBB, 0xBF}, 3},
+    byte_order_mark {encoding_id::utf32le, {0xFF, 0xFE, 0x00, 0x00}, 4},
+    byte_order_mark {encoding_id::utf32be, {0x00, 0x00, 0xFE, 0xFF}, 4},
+    byte_order_mark {encoding_id::utf16le, {0xFF, 0xFE}, 2},
+    byte_order_mark {encoding_id::utf16be, {0xFE, 0xFF}, 2},
+};
+
+// Byte statistics of the prefix of a buffer.
+struct byte_statistics {
+
+    // Zero bytes at each position modulo 4.
+    std::array<size_t, 4> zeros {};
+
+    // Zero code units of 16 and 32 bits.
+    size_t zero_pairs = 0;
+    size_t zero_quads = 0;
+
+    // Control characters other than tabs and line breaks.
+    size_t controls = 0;
+
+    // Distinct values of the bytes at even and odd positions.
+    std::array<size_t, 2> distinct {};
+
+    size_t size = 0;
+};
+
+// A word with 0x80 in the bytes at the positions of pattern, in memory
+// order whatever the byte order of the machine.
+constexpr auto byte_mask(std::array<uint8_t, 8> pattern) noexcept -> uint64_t {
+    return std::bit_cast<uint64_t>(pattern);
+}
+
+// Moves each byte of a word onto the byte before it in memory.
+constexpr auto next_byte(uint64_t word) noexcept -> uint64_t {
+    return std::endian::native == std::endian::little ? word >> 8 : word << 8;
+}
+
+// Statistics of size bytes, a multiple of 8, gathered a word at a time. A
+// byte is zero exactly when adding 0x7F to its low bits carries nothing
+// into its high bit, which finds the zero bytes of a word without branches.
+inline auto gather_byte_statistics(const std::byte* data, size_t size) noexcept -> byte_statistics {
+    constexpr auto low_bits = uint64_t {0x7F7F7F7F7F7F7F7F};
+    constexpr auto positions = std::array {
+        byte_mask({0x80, 0, 0, 0, 0x80, 0, 0, 0}),
+        byte_mask({0, 0x80, 0, 0, 0, 0x80, 0, 0}),
+        byte_mask({0, 0, 0x80, 0, 0, 0, 0x80, 0}),
+        byte_mask({0, 0, 0, 0x80, 0, 0, 0, 0x80}),
+    };
+
+    auto stats = byte_statistics {};
+    auto seen = std::array<std::array<uint64_t, 4>, 2> {};
+
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        auto word = uint64_t {};
+        std::memcpy(&word, data + i, sizeof(word));
+
+        auto zeros = ~(((word & low_bits) + low_bits) | word | low_bits);
+        auto pairs = zeros & next_byte(zeros) & (positions[0] | positions[2]);
+        auto quads = pairs & next_byte(next_byte(pairs)) & positions[0];
+
+        for (size_t k = 0; k < positions.size(); k++) {
+            stats.zeros[k] += std::popcount(zeros & positions[k]);
+        }
+
+        stats.zero_pairs += std::popcount(pairs);
+        stats.zero_quads += std::popcount(quads);
+
+        for (size_t j = 0; j < sizeof(word); j++) {
+            auto value = static_cast<uint8_t>(data[i + j]);
+            seen[j % 2][value / 64] |= uint64_t {1} << (value % 64);
+            stats.controls += value != 0 && value < 0x20 && value != '\t' && value != '\n' && value != '\r';
+        }
+    }
+
+    for (size_t parity = 0; parity < seen.size(); parity++) {
+        for (auto bits : seen[parity]) stats.distinct[parity] += std::popcount(bits);
+    }
+
+    stats.size = size;
+    return stats;
+}
+
+// How well the prefix of a buffer of total_size bytes fits encoding E:
+// the part of it that is valid, weighted by how rare NUL code units are
+// and, for UTF-16, by how much more the low bytes of code units vary than
+// the high ones, as characters cluster in blocks.
+template<encoding E>
+auto detection_score(const std::byte* prefix, size_t size, size_t total_size, const byte_statistics& stats)
+    noexcept -> double
+{
+    using code_unit = typename E::code_unit;
+
+    constexpr auto bits = utf_traits<E>::bits;
+    constexpr auto little = utf_traits<E>::endian == std::endian::little;
+
+    auto units = size / sizeof(code_unit);
+
+    if (total_size % sizeof(code_unit) != 0 || units == 0) {
+        return 0;
+    }
+
+    auto begin = reinterpret_cast<const code_unit*>(prefix);
+    auto end = begin + units;
+
+    // The last code point of a prefix may be cut short. A code point has at
+    // most 4 bytes, which bounds the search for its start in invalid input.
+    if (size < total_size) {
+        auto limit = end - std::min(units, 4 / sizeof(code_unit));
+        end = code_point_start<E>(limit, end - 1);
+    }
+
+    auto valid = end == begin ? 1.0 : static_cast<double>(find_invalid<E>(begin, end) - begin) / (end - begin);
+
+    if (stats.size == 0) {
+        return valid;
+    }
+
+    auto fraction = [](size_t count, size_t total) {
+        return static_cast<double>(count) / static_cast<double>(total);
+    };
+
+    if constexpr (bits == 8) {
+        auto zeros = stats.zeros[0] + stats.zeros[1] + stats.zeros[2] + stats.zeros[3];
+        return valid * (1 - fraction(zeros + stats.controls, stats.size));
+    } else if constexpr (bits == 16) {
+        auto low = stats.distinct[little ? 0 : 1];
+        auto order = fraction(low, stats.distinct[0] + stats.distinct[1]);
+        return valid * (1 - fraction(stats.zero_pairs, stats.size / 2)) * order;
+    } else {
+        return valid * (1 - fraction(stats.zero_quads, stats.size / 4));
+    }
+}
+
+} // namespace detail
+} // namespace unicode
+
+// Guesses the encoding of bytes from their byte order mark, or otherwise
+// from the statistics of their first few kilobytes and from how much of
+// them is valid in each encoding.
+inline auto detect_encoding(std::span<const std::byte> bytes) noexcept -> encoding_detection {
+    for (auto& bom : unicode::detail::byte_order_marks) {
+        if (bytes.size() >= bom.size && std::memcmp(bytes.data(), bom.bytes.data(), bom.size) == 0) {
+            return {bom.encoding, 1, bom.size};
+        }
+    }
+
+    // Copied so that code units of any size can be read from it.
+    alignas(uint64_t) auto prefix = std::array<std::byte, unicode::detail::detection_prefix_size> {};
+
+    auto size = std::min(bytes.size(), prefix.size());
+    std::copy_n(bytes.data(), size, prefix.data());
+
+    auto stats = unicode::detail::gather_byte_statistics(prefix.data(), size / sizeof(uint64_t) * sizeof(uint64_t));
+    auto best = encoding_detection {};
+
+    for (auto id : unicode::encoding_ids) {
+        auto score = unicode::detail::visit_encoding(id, [&]<typename E>(std::type_identity<E>) {
+            return unicode::detail::detection_score<E>(prefix.data(), size, bytes.size(), stats);
+        });
+
+        if (score > best.confidence) {
+            best = {id, score, 0};
+        }
+    }
+
+    return best;
+}
+
+// Detects the encoding of bytes and validates all of them in it, past the
+// byte order mark unless it is kept. Throws parse_error if they are not
+// valid in the detected encoding and invalid_argument if they are not
+// aligned to its code units.
+inline auto detect_string(std::span<const std::byte> bytes, bool strip_bom = true) -> detected_string {
+    auto detection = detect_encoding(bytes);
+    auto skipped = strip_bom ? detection.bom_size : 0;
+
+    return {any_string_view {bytes.subspan(skipped), detection.encoding}, detection};
+}
+
+} // namespace bigj
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "unicode/detail/count.hpp"
+#include "unicode/detail/grapheme.hpp"
+#include "unicode/detail/search.hpp"
+#include "unicode/iterator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+
+namespace bigj {
+
+enum class column_unit {
+    code_point,
+    utf16,
+    grapheme,
+};
+
+struct text_position {
+    size_t line = 0;
+    size_t column = 0;
+
+    friend constexpr auto operator==(const text_position&, const text_position&) noexcept
+        -> bool = default;
+
+    friend constexpr auto operator<=>(const text_position&, const text_position&) noexcept = default;
+};
+
+// Maps offsets in code units of a text to lines and columns and back. The
+// start of every line is found once when the index is built, so a lookup
+// is a binary search followed by counting the columns of a single line.
+// Lines end after "\n", and the text must outlive the index.
+template<unicode::encoding E>
+struct line_index {
+
+    using code_unit = typename E::code_unit;
+    using size_type = size_t;
+
+    line_index() : m_line_starts {0} {}
+
+    explicit line_index(basic_string_view<E> text) : m_text {text}, m_line_starts {0} {
+        auto units = text.code_units();
+        add_line_starts(units.begin(), units.end());
+    }
+
+    auto text() const noexcept -> basic_string_view<E> {
+        return m_text;
+    }
+
+    auto line_count() const noexcept -> size_type {
+        return m_line_starts.size();
+    }
+
+    // Offset of the first code unit of a line.
+    auto line_start(size_type line) const -> size_type {
+        if (line >= line_count()) [[unlikely]] {
+            throw std::out_of_range {"line is out of range"};
+        }
+
+        return m_line_starts[line];
+    }
+
+    // Offset of the line feed ending a line, or of the end of the text.
+    auto line_end(size_type line) const -> size_type {
+        if (line >= line_count()) [[unlikely]] {
+            throw std::out_of_range {"line is out of range"};
+        } else if (line == line_count() - 1) {
+            return m_text.code_units().size();
+        } else {
+            return m_line_starts[line + 1] - newline().size();
+        }
+    }
+
+    auto line(size_type offset) const -> size_type {
+        check_offset(offset);
+
+        auto it = std::ranges::upper_bound(m_line_starts, offset);
+        return static_cast<size_type>(it - m_line_starts.begin()) - 1;
+    }
+
+    auto position(size_type offset, column_unit unit = column_unit::code_point) const
+        -> text_position
+    {
+        auto line = this->line(offset);
+        auto units = m_text.code_units().begin();
+        auto begin = units + m_line_starts[line];
+        auto end = units + offset;
+
+        switch (unit) {
+            case column_unit::code_point:
+                return {line, unicode::detail::count_code_points<E>(begin, end)};
+            case column_unit::utf16:
+                return {line, unicode::detail::count_utf16_units<E>(begin, end)};
+            default:
+                return {line, count_graphemes(begin, end)};
+        }
+    }
+
+    // Returns the offset of a position. Columns past the end of their line
+    // are clamped to it, and a column that falls inside a code point or a
+    // grapheme cluster resolves to its start.
+    auto offset(text_position position, column_unit unit = column_unit::code_point) const
+        -> size_type
+    {
+        auto units = m_text.code_units().begin();
+        auto begin = units + line_start(position.line);
+        auto end = units + line_end(position.line);
+        auto column = position.column;
+
+        switch (unit) {
+            case column_unit::code_point:
+                begin = unicode::detail::advance_code_points<E>(begin, end, column);
+                break;
+            case column_unit::utf16:
+                begin = unicode::detail::advance_utf16_units<E>(begin, end, column);
+                break;
+            default:
+                begin = advance_graphemes(begin, end, column);
+                break;
+        }
+
+        return static_cast<size_type>(begin - units);
+    }
+
+    // Updates the index after an edit replaced removed code units at offset
+    // with inserted ones, text being the edited text. Only the inserted code
+    // units are scanned.
+    auto update(basic_string_view<E> text, size_type offset, size_type removed, size_type inserted)
+        -> void
+    {
+        auto old_size = m_text.code_units().size();
+        auto new_size = text.code_units().size();
+
+        if (
+            offset > old_size || removed > old_size - offset
+            || new_size != old_size - removed + inserted
+        ) [[unlikely]] {
+            throw std::out_of_range {"edit is out of range"};
+        }
+
+        auto first = std::ranges::upper_bound(m_line_starts, offset);
+        auto last = std::ranges::upper_bound(m_line_starts, offset + removed);
+
+        for (auto it = last; it != m_line_starts.end(); it++) {
+            *it = *it - removed + inserted;
+        }
+
+        auto tail = std::vector<size_type>(last, m_line_starts.end());
+        m_line_starts.erase(first, m_line_starts.end());
+
+        auto units = text.code_units().begin();
+        m_text = text;
+        add_line_starts(units + offset, units + offset + inserted);
+        m_line_starts.insert(m_line_starts.end(), tail.begin(), tail.end());
+    }
+
+  private:
+    static auto newline() noexcept -> unicode::detail::encoded_code_point<E> {
+        return unicode::detail::encoded_code_point<E> {U'\n'};
+    }
+
+    auto check_offset(size_type offset) const -> void {
+        if (offset > m_text.code_units().size()) [[unlikely]] {
+            throw std::out_of_range {"offset is out of range"};
+        }
+    }
+
+    auto add_line_starts(const code_unit* it, const code_unit* end) -> void {
+        auto base = m_text.code_units().begin();
+        auto needle = newline();
+
+        while (auto match = unicode::detail::find_string<E>(it, end, needle.begin(), needle.end())) {
+            it = match + needle.size();
+            m_line_starts.push_back(static_cast<size_type>(it - base));
+        }
+    }
+
+    static auto count_graphemes(const code_unit* it, const code_unit* end) -> size_type {
+        auto breaker = unicode::detail::grapheme_breaker {};
+        auto count = size_type {0};
+
+        for (auto cp = unicode::iterator<E> {it}; cp != unicode::iterator<E> {end}; cp++) {
+            count += breaker.is_break(*cp);
+        }
+
+        return count;
+    }
+
+    static auto advance_graphemes(const code_unit* it, const code_unit* end, size_type n)
+        -> const code_unit*
+    {
+        auto breaker = unicode::detail::grapheme_breaker {};
+        auto cp = unicode::iterator<E> {it};
+
+        for (; cp != unicode::iterator<E> {end}; cp++) {
+            if (breaker.is_break(*cp) && n-- == 0) break;
+        }
+
+        return cp.address();
+    }
+
+    basic_string_view<E> m_text;
+    std::vector<size_type> m_line_starts;
+};
+
+} // namespace bigj
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "string.hpp"
+#include "unicode/detail/fixed_string.hpp"
+
+#include <array>
+
+#include <cstddef>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+template<typename CharT>
+struct literal_encoding;
+
+template<>
+struct literal_encoding<char8_t> {
+    using type = utf8;
+};
+
+template<>
+struct literal_encoding<char16_t> {
+    using type = utf16<std::endian::native>;
+};
+
+template<>
+struct literal_encoding<char32_t> {
+    using type = utf32<std::endian::native>;
+};
+
+// Validates and transcodes a string literal at compile time. The resulting
+// code units are stored in a static array, which strings created from the
+// literal point to without ever allocating or counting references.
+template<encoding E, auto S>
+struct string_literal {
+
+    using source = typename literal_encoding<typename decltype(S)::value_type>::type;
+    using source_unit = typename source::code_unit;
+    using code_unit = typename E::code_unit;
+
+    static constexpr auto input = [] {
+        auto units = std::array<source_unit, S.size()> {};
+
+        for (size_t i = 0; i < units.size(); i++) {
+            units[i] = static_cast<source_unit>(S.chars[i]);
+        }
+
+        return units;
+    }();
+
+    static constexpr auto error = [] {
+        auto begin = input.data();
+        auto end = begin + input.size();
+
+        for (auto it = begin; it != end; it = source::next_code_point(it)) {
+            if (auto ec = source::validate(it, end); ec != error_code::ok) {
+                return ec;
+            }
+        }
+
+        return error_code::ok;
+    }();
+
+    static_assert(error == error_code::ok, "string literal is not valid unicode");
+
+    static constexpr auto text = error == error_code::ok
+        ? basic_string_view<source> {input.data(), input.size()}
+        : basic_string_view<source> {};
+
+    static constexpr auto length = text.length();
+
+    static constexpr auto size = [] {
+        auto size = size_t {0};
+
+        for (auto cp : text.code_points()) {
+            size += E::encoded_size(cp);
+        }
+
+        return size;
+    }();
+
+    static constexpr auto units = [] {
+        auto units = std::array<code_unit, size + 1> {};
+        auto data = units.data();
+
+        for (auto cp : text.code_points()) {
+            data = E::encode(cp, data);
+        }
+
+        return units;
+    }();
+
+    static auto make() noexcept -> basic_string<E> {
+        return basic_string<E>::from_static(units.data(), units.data() + size, length);
+    }
+};
+
+} // namespace detail
+} // namespace unicode
+
+namespace literals {
+
+template<unicode::detail::fixed_string S>
+auto operator""_s() noexcept {
+    using E = typename unicode::detail::literal_encoding<typename decltype(S)::value_type>::type;
+    return unicode::detail::string_literal<E, S>::make();
+}
+
+template<unicode::detail::fixed_string S>
+auto operator""_u8() noexcept -> utf8_string {
+    return unicode::detail::string_literal<unicode::utf8, S>::make();
+}
+
+template<unicode::detail::fixed_string S>
+auto operator""_u16be() noexcept -> utf16be_string {
+    return unicode::detail::string_literal<unicode::utf16be, S>::make();
+}
+
+template<unicode::detail::fixed_string S>
+auto operator""_u16le() noexcept -> utf16le_string {
+    return unicode::detail::string_literal<unicode::utf16le, S>::make();
+}
+
+template<unicode::detail::fixed_string S>
+auto operator""_u32be() noexcept -> utf32be_string {
+    return unicode::detail::string_literal<unicode::utf32be, S>::make();
+}
+
+template<unicode::detail::fixed_string S>
+auto operator""_u32le() noexcept -> utf32le_string {
+    return unicode::detail::string_literal<unicode::utf32le, S>::make();
+}
+
+} // namespace literals
+} // namespace bigj
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "unicode/detail/count.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+
+namespace bigj {
+
+// What an offset into a string counts: its own code units, code points, or
+// the code units it would have in UTF-16.
+enum class offset_unit {
+    code_unit,
+    code_point,
+    utf16,
+};
+
+namespace unicode {
+namespace detail {
+
+// A position in a string known in every offset unit at once, which moves
+// forward by counting the code units in between.
+template<encoding E>
+struct offset_cursor {
+
+    using code_unit = typename E::code_unit;
+
+    const code_unit* it = nullptr;
+    size_t code_points = 0;
+    size_t utf16_units = 0;
+
+    auto get(const code_unit* begin, offset_unit unit) const noexcept -> size_t {
+        switch (unit) {
+            case offset_unit::code_unit:
+                return static_cast<size_t>(it - begin);
+            case offset_unit::code_point:
+                return code_points;
+            default:
+                return utf16_units;
+        }
+    }
+
+    // Moves forward to an offset, which must not be behind the cursor. An
+    // offset that falls inside a code point resolves to its start.
+    auto seek(const code_unit* begin, const code_unit* end, size_t offset, offset_unit unit) -> void {
+        auto next = it;
+        auto n = offset - get(begin, unit);
+
+        switch (unit) {
+            case offset_unit::code_unit:
+                if (offset > static_cast<size_t>(end - begin)) [[unlikely]] {
+                    throw std::out_of_range {"offset is out of range"};
+                }
+
+                n = 0;
+                next = begin + offset == end ? end : code_point_start<E>(it, begin + offset);
+                break;
+            case offset_unit::code_point:
+                next = advance_code_points<E>(it, end, n);
+                break;
+            default:
+                next = advance_utf16_units<E>(it, end, n);
+                if (n == 1 && next != end) n = 0;
+                break;
+        }
+
+        if (n != 0) [[unlikely]] {
+            throw std::out_of_range {"offset is out of range"};
+        }
+
+        code_points += count_code_points<E>(it, next);
+        utf16_units += count_utf16_units<E>(it, next);
+        it = next;
+    }
+};
+
+} // namespace detail
+} // namespace unicode
+
+// Converts an offset into str from one unit to another, counting from the
+// start of str. Offsets inside a code point resolve to its start.
+template<unicode::detail::string_like S>
+auto convert_offset(const S& str, size_t offset, offset_unit from, offset_unit to) -> size_t {
+    using E = unicode::detail::string_encoding_t<S>;
+
+    auto units = unicode::detail::as_view(str).code_units();
+    auto cursor = unicode::detail::offset_cursor<E> {units.begin()};
+
+    cursor.seek(units.begin(), units.end(), offset, from);
+    return cursor.get(units.begin(), to);
+}
+
+// Converts a list of offsets in ascending order in a single pass over str.
+template<unicode::detail::string_like S, std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, size_t>
+auto convert_offsets(const S& str, R&& offsets, offset_unit from, offset_unit to)
+    -> std::vector<size_t>
+{
+    using E = unicode::detail::string_encoding_t<S>;
+
+    auto units = unicode::detail::as_view(str).code_units();
+    auto cursor = unicode::detail::offset_cursor<E> {units.begin()};
+    auto result = std::vector<size_t> {};
+
+    for (size_t offset : offsets) {
+        if (offset < cursor.get(units.begin(), from)) [[unlikely]] {
+            throw std::invalid_argument {"offsets are not sorted"};
+        }
+
+        cursor.seek(units.begin(), units.end(), offset, from);
+        result.push_back(cursor.get(units.begin(), to));
+    }
+
+    return result;
+}
+
+// Records the offsets of a text in every unit at regular intervals, so that
+// a conversion only counts from the closest checkpoint before it. The text
+// must outlive the index.
+template<unicode::encoding E>
+struct offset_index {
+
+    using code_unit = typename E::code_unit;
+    using size_type = size_t;
+
+    static constexpr auto default_interval = size_type {4096};
+
+    offset_index() : m_checkpoints {cursor_type {}} {}
+
+    // Places a checkpoint every interval code points.
+    explicit offset_index(basic_string_view<E> text, size_type interval = default_interval)
+        : m_text {text}
+    {
+        if (interval == 0) [[unlikely]] {
+            throw std::invalid_argument {"interval must not be zero"};
+        }
+
+        auto units = text.code_units();
+        auto cursor = cursor_type {units.begin()};
+
+        m_checkpoints.push_back(cursor);
+
+        while (true) {
+            auto n = interval;
+            auto next = unicode::detail::advance_code_points<E>(cursor.it, units.end(), n);
+            if (next == units.end()) break;
+
+            cursor.code_points += interval;
+            cursor.utf16_units += unicode::detail::count_utf16_units<E>(cursor.it, next);
+            cursor.it = next;
+            m_checkpoints.push_back(cursor);
+        }
+    }
+
+    auto text() const noexcept -> basic_string_view<E> {
+        return m_text;
+    }
+
+    auto convert(size_type offset, offset_unit from, offset_unit to) const -> size_type {
+        auto units = m_text.code_units();
+        auto cursor = checkpoint(offset, from);
+
+        cursor.seek(units.begin(), units.end(), offset, from);
+        return cursor.get(units.begin(), to);
+    }
+
+    // Converts a list of offsets in ascending order, moving on from one to
+    // the next and jumping ahead to checkpoints where they are far apart.
+    template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, size_type>
+    auto convert(R&& offsets, offset_unit from, offset_unit to) const -> std::vector<size_type> {
+        auto units = m_text.code_units();
+        auto cursor = m_checkpoints.front();
+        auto result = std::vector<size_type> {};
+
+        for (size_type offset : offsets) {
+            auto current = cursor.get(units.begin(), from);
+
+            if (offset < current) [[unlikely]] {
+                throw std::invalid_argument {"offsets are not sorted"};
+            }
+
+            if (auto closest = checkpoint(offset, from); closest.get(units.begin(), from) > current) {
+                cursor = closest;
+            }
+
+            cursor.seek(units.begin(), units.end(), offset, from);
+            result.push_back(cursor.get(units.begin(), to));
+        }
+
+        return result;
+    }
+
+  private:
+    using cursor_type = unicode::detail::offset_cursor<E>;
+
+    auto checkpoint(size_type offset, offset_unit unit) const -> cursor_type {
+        auto begin = m_text.code_units().begin();
+
+        auto it = std::ranges::upper_bound(m_checkpoints, offset, {}, [&](const cursor_type& cursor) {
+            return cursor.get(begin, unit);
+        });
+
+        return *std::prev(it);
+    }
+
+    basic_string_view<E> m_text;
+    std::vector<cursor_type> m_checkpoints;
+};
+
+} // namespace bigj
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "unicode/detail/decode.hpp"
+#include "unicode/detail/search.hpp"
+#include "unicode/iterator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <initializer_list>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bigj {
+
+// A set of patterns compiled for matching against many texts, each of which
+// is scanned once whatever the number of patterns. A few patterns with few
+// distinct first code units are found by filtering candidate positions a
+// word at a time, larger sets by an Aho-Corasick automaton running over the
+// bytes of the code units.
+template<unicode::encoding E>
+struct pattern_set {
+
+    static_assert(
+        unicode::detail::utf_traits<E>::bits != 0,
+        "pattern_set requires a self-synchronizing encoding"
+    );
+
+    using code_unit = typename E::code_unit;
+    using const_iterator = unicode::iterator<E>;
+    using size_type = size_t;
+
+    struct match {
+        size_type pattern;
+        const_iterator begin;
+        const_iterator end;
+
+        friend auto operator==(const match&, const match&) -> bool = default;
+    };
+
+    pattern_set(std::initializer_list<basic_string_view<E>> patterns)
+        : pattern_set {std::views::all(patterns)} {}
+
+    template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, basic_string_view<E>>
+    explicit pattern_set(R&& patterns) {
+        m_offsets.push_back(0);
+
+        for (basic_string_view<E> pattern : patterns) {
+            auto units = pattern.code_units();
+
+            if (units.empty()) [[unlikely]] {
+                throw std::invalid_argument {"empty pattern"};
+            }
+
+            m_units.insert(m_units.end(), units.begin(), units.end());
+            m_offsets.push_back(m_units.size());
+        }
+
+        for (size_type i = 0; i < size(); i++) {
+            auto first = pattern_units(i)[0];
+
+            if (std::ranges::find(m_first_units, first) == m_first_units.end()) {
+                m_first_units.push_back(first);
+            }
+        }
+
+        if (size() > max_filtered_patterns || m_first_units.size() > max_filtered_units) {
+            m_first_units.clear();
+            build_automaton();
+        }
+    }
+
+    // Number of patterns in the set.
+    auto size() const noexcept -> size_type {
+        return m_offsets.size() - 1;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return size() == 0;
+    }
+
+    auto pattern(size_type index) const -> basic_string_view<E> {
+        if (index >= size()) [[unlikely]] {
+            throw std::out_of_range {"pattern index is out of range"};
+        }
+
+        auto units = pattern_units(index);
+        return basic_string_view<E> {units.data(), units.data() + units.size()};
+    }
+
+    auto contains(basic_string_view<E> text) const noexcept -> bool {
+        auto found = false;
+
+        scan(text, [&](size_type, size_type) {
+            found = true;
+            return false;
+        });
+
+        return found;
+    }
+
+    // Returns the match that starts first in text, breaking ties by the
+    // lowest pattern index.
+    auto find(basic_string_view<E> text) const -> std::optional<match> {
+        auto units = text.code_units();
+        auto best_start = size_type {0};
+        auto best_pattern = size();
+
+        if (is_filtered()) {
+            scan(text, [&](size_type start, size_type pattern) {
+                best_start = start;
+                best_pattern = pattern;
+                return false;
+            });
+        } else {
+            // Matches are found in order of their end, so the scan goes on
+            // until no match starting earlier than the best one can follow.
+            auto bytes = reinterpret_cast<const uint8_t*>(units.begin());
+            auto state = uint32_t {0};
+
+            for (size_type i = 0; i < sizeof(code_unit) * units.size(); i++) {
+                state = m_transitions[state * m_class_count + m_classes[bytes[i]]];
+
+                if (best_pattern != size() && i + 1 - m_depths[state] > sizeof(code_unit) * best_start) {
+                    break;
+                }
+
+                automaton_matches(state, i + 1, [&](size_type start, size_type pattern) {
+                    if (start < best_start || best_pattern == size()
+                        || (start == best_start && pattern < best_pattern))
+                    {
+                        best_start = start;
+                        best_pattern = pattern;
+                    }
+
+                    return true;
+                });
+            }
+        }
+
+        if (best_pattern == size()) {
+            return std::nullopt;
+        } else {
+            return make_match(units.begin(), best_start, best_pattern);
+        }
+    }
+
+    // Returns every match in text, overlapping ones included, ordered by
+    // their start and then by pattern index.
+    auto find_all(basic_string_view<E> text) const -> std::vector<match> {
+        auto units = text.code_units();
+        auto matches = std::vector<match> {};
+
+        scan(text, [&](size_type start, size_type pattern) {
+            matches.push_back(make_match(units.begin(), start, pattern));
+            return true;
+        });
+
+        if (!is_filtered()) {
+            std::ranges::sort(matches, [](const match& lhs, const match& rhs) {
+                if (lhs.begin != rhs.begin) {
+                    return lhs.begin.address() < rhs.begin.address();
+                } else {
+                    return lhs.pattern < rhs.pattern;
+                }
+            });
+        }
+
+        return matches;
+    }
+
+  private:
+    static constexpr auto max_filtered_patterns = size_type {16};
+    static constexpr auto max_filtered_units = size_type {4};
+
+    auto pattern_units(size_type index) const noexcept -> std::span<const code_unit> {
+        return {m_units.data() + m_offsets[index], m_units.data() + m_offsets[index + 1]};
+    }
+
+    auto is_filtered() const noexcept -> bool {
+        return !m_first_units.empty() || empty();
+    }
+
+    auto make_match(const code_unit* text, size_type start, size_type pattern) const -> match {
+        auto begin = text + start;
+        return {pattern, const_iterator {begin}, const_iterator {begin + pattern_units(pattern).size()}};
+    }
+
+    // Calls f(start, pattern) with the offset in code units of each match
+    // until it returns false. The filter reports matches in the order of
+    // their start, the automaton in the order of their end.
+    template<typename F>
+    auto scan(basic_string_view<E> text, F f) const -> void {
+        auto units = text.code_units();
+
+        if (is_filtered()) {
+            scan_filtered(units.begin(), units.size(), f);
+        } else {
+            auto bytes = reinterpret_cast<const uint8_t*>(units.begin());
+            auto state = uint32_t {0};
+
+            for (size_type i = 0; i < sizeof(code_unit) * units.size(); i++) {
+                state = m_transitions[state * m_class_count + m_classes[bytes[i]]];
+                if (!automaton_matches(state, i + 1, f)) return;
+            }
+        }
+    }
+
+    template<typename F>
+    auto scan_filtered(const code_unit* text, size_type length, F& f) const -> void {
+        using lanes = unicode::detail::unit_lanes<code_unit>;
+
+        auto words = std::array<uint64_t, max_filtered_units> {};
+
+        for (size_type i = 0; i < m_first_units.size(); i++) {
+            words[i] = lanes::broadcast(m_first_units[i]);
+        }
+
+        auto check = [&](size_type i) {
+            for (size_type p = 0; p < size(); p++) {
+                auto units = pattern_units(p);
+
+                if (units.size() <= length - i
+                    && std::memcmp(text + i, units.data(), sizeof(code_unit) * units.size()) == 0
+                    && !f(i, p))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        auto i = size_type {0};
+
+        for (; length - i >= lanes::count; i += lanes::count) {
+            auto word = lanes::load(text + i);
+            auto mask = uint64_t {0};
+
+            for (size_type u = 0; u < m_first_units.size(); u++) {
+                mask |= lanes::zero_lanes(word ^ words[u]);
+            }
+
+            for (; mask; mask &= mask - 1) {
+                if (!check(i + std::countr_zero(mask) / lanes::bits)) return;
+            }
+        }
+
+        for (; i < length; i++) {
+            if (std::ranges::find(m_first_units, text[i]) != m_first_units.end() && !check(i)) {
+                return;
+            }
+        }
+    }
+
+    // Reports the patterns ending at byte offset end in the given state,
+    // skipping those that would start inside a code unit.
+    template<typename F>
+    auto automaton_matches(uint32_t state, size_type end, F&& f) const -> bool {
+        if (m_output_offsets[state] == m_output_offsets[state + 1]) {
+            state = m_dictionary_links[state];
+        }
+
+        for (; state != 0; state = m_dictionary_links[state]) {
+            for (auto o = m_output_offsets[state]; o != m_output_offsets[state + 1]; o++) {
+                auto pattern = m_outputs[o];
+                auto start = end - sizeof(code_unit) * pattern_units(pattern).size();
+
+                if (start % sizeof(code_unit) == 0 && !f(start / sizeof(code_unit), pattern)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    auto build_automaton() -> void {
+        auto bytes = reinterpret_cast<const uint8_t*>(m_units.data());
+
+        // Bytes that appear in no pattern share class 0, so the table only
+        // needs as many columns as there are distinct bytes in the patterns.
+        m_classes.fill(0);
+        m_class_count = 1;
+
+        for (size_type i = 0; i < sizeof(code_unit) * m_units.size(); i++) {
+            if (m_classes[bytes[i]] == 0) {
+                m_classes[bytes[i]] = static_cast<uint16_t>(m_class_count++);
+            }
+        }
+
+        auto trie_outputs = std::vector<std::vector<uint32_t>> {1};
+        m_transitions.assign(m_class_count, 0);
+        m_depths.assign(1, 0);
+
+        for (size_type p = 0; p < size(); p++) {
+            auto it = bytes + sizeof(code_unit) * m_offsets[p];
+            auto end = bytes + sizeof(code_unit) * m_offsets[p + 1];
+            auto state = uint32_t {0};
+
+            for (; it != end; it++) {
+                auto& next = m_transitions[state * m_class_count + m_classes[*it]];
+
+                if (next == 0) {
+                    next = static_cast<uint32_t>(m_depths.size());
+                    m_depths.push_back(m_depths[state] + 1);
+                    trie_outputs.emplace_back();
+                    m_transitions.resize(m_transitions.size() + m_class_count, 0);
+                }
+
+                state = m_transitions[state * m_class_count + m_classes[*it]];
+            }
+
+            trie_outputs[state].push_back(static_cast<uint32_t>(p));
+        }
+
+        auto state_count = m_depths.size();
+        auto failure_links = std::vector<uint32_t>(state_count, 0);
+        m_dictionary_links.assign(state_count, 0);
+
+        // States are visited breadth first so the failure link of a state
+        // has its row of the table complete by the time the state is.
+        auto queue = std::vector<uint32_t> {0};
+
+        for (size_type q = 0; q < queue.size(); q++) {
+            auto state = queue[q];
+            auto row = m_transitions.data() + state * m_class_count;
+            auto failure_row = m_transitions.data() + failure_links[state] * m_class_count;
+
+            for (size_type c = 0; c < m_class_count; c++) {
+                if (row[c] != 0) {
+                    auto child = row[c];
+                    auto link = state == 0 ? 0 : failure_row[c];
+
+                    failure_links[child] = link;
+                    m_dictionary_links[child] = trie_outputs[link].empty()
+                        ? m_dictionary_links[link] : link;
+
+                    queue.push_back(child);
+                } else if (state != 0) {
+                    row[c] = failure_row[c];
+                }
+            }
+        }
+
+        m_output_offsets.assign(1, 0);
+        m_outputs.clear();
+
+        for (auto& outputs : trie_outputs) {
+            m_outputs.insert(m_outputs.end(), outputs.begin(), outputs.end());
+            m_output_offsets.push_back(static_cast<uint32_t>(m_outputs.size()));
+        }
+    }
+
+    std::vector<code_unit> m_units;
+    std::vector<size_type> m_offsets;
+    std::vector<code_unit> m_first_units;
+
+    std::array<uint16_t, 256> m_classes {};
+    size_type m_class_count = 0;
+    std::vector<uint32_t> m_transitions;
+    std::vector<uint32_t> m_depths;
+    std::vector<uint32_t> m_dictionary_links;
+    std::vector<uint32_t> m_output_offsets;
+    std::vector<uint32_t> m_outputs;
+};
+
+} // namespace bigj
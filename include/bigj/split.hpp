@@ -0,0 +1,279 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "pattern_set.hpp"
+#include "unicode/detail/search.hpp"
+#include "unicode/iterator.hpp"
+
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstring>
+
+namespace bigj {
+
+// Lazily splits a string into the views between the matches of a
+// delimiter. Nothing is copied or allocated per piece, and the string must
+// outlive the view. Finder is called with the rest of the string and
+// returns the bounds of the next delimiter in it, or twice its end if there
+// is none.
+template<unicode::encoding E, typename Finder>
+struct split_view : std::ranges::view_interface<split_view<E, Finder>> {
+
+    using code_unit = typename E::code_unit;
+
+    struct iterator {
+
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = basic_string_view<E>;
+        using difference_type = ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        auto operator*() const -> value_type {
+            auto str = m_parent->m_str;
+            return str.substring(unicode::iterator<E> {m_begin}, unicode::iterator<E> {m_end});
+        }
+
+        auto operator++() -> iterator& {
+            if (m_trailing) {
+                m_begin = m_end = m_next;
+                m_trailing = false;
+            } else if (m_next == m_parent->m_str.code_units().end()) {
+                m_done = true;
+            } else {
+                advance(m_next);
+            }
+
+            return *this;
+        }
+
+        auto operator++(int) -> iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend auto operator==(const iterator& lhs, const iterator& rhs) noexcept -> bool {
+            return lhs.m_done == rhs.m_done && (lhs.m_done || (
+                lhs.m_begin == rhs.m_begin && lhs.m_trailing == rhs.m_trailing
+            ));
+        }
+
+        friend auto operator==(const iterator& it, std::default_sentinel_t) noexcept -> bool {
+            return it.m_done;
+        }
+
+      private:
+        friend struct split_view;
+
+        explicit iterator(const split_view* parent) : m_parent {parent} {
+            auto units = parent->m_str.code_units();
+
+            if (units.empty()) {
+                m_done = true;
+            } else {
+                advance(units.begin());
+            }
+        }
+
+        auto advance(const code_unit* it) -> void {
+            auto str = m_parent->m_str;
+            auto end = str.code_units().end();
+            auto rest = str.substring(unicode::iterator<E> {it}, str.end());
+            auto [match, match_end] = m_parent->m_finder(rest);
+
+            m_begin = it;
+            m_end = match;
+            m_next = match_end;
+            m_trailing = match != end && match_end == end && m_parent->m_trailing;
+        }
+
+        const split_view* m_parent = nullptr;
+        const code_unit* m_begin = nullptr;
+        const code_unit* m_end = nullptr;
+        const code_unit* m_next = nullptr;
+        bool m_trailing = false;
+        bool m_done = false;
+    };
+
+    split_view() noexcept = default;
+
+    split_view(basic_string_view<E> str, Finder finder, bool trailing = true)
+        : m_str {str}, m_finder {std::move(finder)}, m_trailing {trailing} {}
+
+    auto begin() const -> iterator {
+        return iterator {this};
+    }
+
+    auto end() const noexcept -> std::default_sentinel_t {
+        return std::default_sentinel;
+    }
+
+  private:
+    basic_string_view<E> m_str;
+    Finder m_finder;
+    bool m_trailing = true;
+};
+
+namespace unicode {
+namespace detail {
+
+template<encoding E>
+struct string_finder {
+    using code_unit = typename E::code_unit;
+
+    auto operator()(basic_string_view<E> str) const noexcept
+        -> std::pair<const code_unit*, const code_unit*>
+    {
+        auto it = str.code_units().begin();
+        auto end = str.code_units().end();
+        auto units = delimiter.code_units();
+
+        if (auto match = find_string<E>(it, end, units.begin(), units.end())) {
+            return {match, match + units.size()};
+        } else {
+            return {end, end};
+        }
+    }
+
+    basic_string_view<E> delimiter;
+};
+
+template<encoding E>
+struct code_point_finder {
+    using code_unit = typename E::code_unit;
+
+    auto operator()(basic_string_view<E> str) const noexcept
+        -> std::pair<const code_unit*, const code_unit*>
+    {
+        auto it = str.code_units().begin();
+        auto end = str.code_units().end();
+
+        if (delimiter.empty()) {
+            return {end, end};
+        } else if (auto match = find_string<E>(it, end, delimiter.begin(), delimiter.end())) {
+            return {match, match + (delimiter.end() - delimiter.begin())};
+        } else {
+            return {end, end};
+        }
+    }
+
+    encoded_code_point<E> delimiter;
+};
+
+// Shares one compiled set between all the copies of a view.
+template<encoding E>
+struct any_finder {
+    using code_unit = typename E::code_unit;
+
+    auto operator()(basic_string_view<E> str) const
+        -> std::pair<const code_unit*, const code_unit*>
+    {
+        if (auto match = delimiters->find(str)) {
+            return {match->begin.address(), match->end.address()};
+        } else {
+            return {str.code_units().end(), str.code_units().end()};
+        }
+    }
+
+    std::shared_ptr<const pattern_set<E>> delimiters;
+};
+
+// Ends each line before a line feed and the carriage return preceding it.
+template<encoding E>
+struct line_finder {
+    using code_unit = typename E::code_unit;
+
+    auto operator()(basic_string_view<E> str) const noexcept
+        -> std::pair<const code_unit*, const code_unit*>
+    {
+        auto it = str.code_units().begin();
+        auto end = str.code_units().end();
+        auto lf = encoded_code_point<E> {U'\n'};
+        auto cr = encoded_code_point<E> {U'\r'};
+        auto cr_size = cr.end() - cr.begin();
+
+        if (auto match = find_string<E>(it, end, lf.begin(), lf.end())) {
+            auto match_end = match + (lf.end() - lf.begin());
+
+            if (match - it >= cr_size
+                && std::memcmp(match - cr_size, cr.begin(), sizeof(code_unit) * cr_size) == 0)
+            {
+                match -= cr_size;
+            }
+
+            return {match, match_end};
+        } else {
+            return {end, end};
+        }
+    }
+};
+
+} // namespace detail
+} // namespace unicode
+
+// Splits str around every occurrence of delimiter. Like std::views::split,
+// a delimiter at the end of str is followed by an empty piece, and an empty
+// str has no pieces.
+template<unicode::detail::string_like S>
+auto split(const S& str, basic_string_view<unicode::detail::string_encoding_t<S>> delimiter) {
+    using E = unicode::detail::string_encoding_t<S>;
+
+    if (delimiter.empty()) [[unlikely]] {
+        throw std::invalid_argument {"empty delimiter"};
+    }
+
+    return split_view<E, unicode::detail::string_finder<E>> {
+        unicode::detail::as_view(str), {delimiter}
+    };
+}
+
+template<unicode::detail::string_like S>
+auto split(const S& str, unicode::code_point delimiter) {
+    using E = unicode::detail::string_encoding_t<S>;
+
+    return split_view<E, unicode::detail::code_point_finder<E>> {
+        unicode::detail::as_view(str), unicode::detail::code_point_finder<E> {
+            unicode::detail::encoded_code_point<E> {delimiter}
+        }
+    };
+}
+
+// Splits str around every occurrence of any of the code points of
+// delimiters.
+template<unicode::detail::string_like S>
+auto split_any(const S& str, basic_string_view<unicode::detail::string_encoding_t<S>> delimiters) {
+    using E = unicode::detail::string_encoding_t<S>;
+
+    auto patterns = std::vector<basic_string_view<E>> {};
+
+    for (auto it = delimiters.begin(); it != delimiters.end(); it++) {
+        patterns.push_back(delimiters.substring(it, std::next(it)));
+    }
+
+    return split_view<E, unicode::detail::any_finder<E>> {
+        unicode::detail::as_view(str), unicode::detail::any_finder<E> {
+            std::make_shared<const pattern_set<E>>(patterns)
+        }
+    };
+}
+
+// Splits str into lines ended by "\n" or "\r\n", which are not part of the
+// lines. A line ending at the end of str is not followed by an empty line.
+template<unicode::detail::string_like S>
+auto lines(const S& str) {
+    using E = unicode::detail::string_encoding_t<S>;
+
+    return split_view<E, unicode::detail::line_finder<E>> {
+        unicode::detail::as_view(str), {}, false
+    };
+}
+
+} // namespace bigj
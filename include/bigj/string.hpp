@@ -15,4 +15,13 @@ using utf32le_string = basic_string<unicode::utf32le>;
 
 using string = utf8_string;
 
+// Strings of half the default size, for large tables of mostly short strings.
+using compact_utf8_string = basic_string<unicode::utf8, compact_inline_bytes>;
+using compact_utf16be_string = basic_string<unicode::utf16be, compact_inline_bytes>;
+using compact_utf32be_string = basic_string<unicode::utf32be, compact_inline_bytes>;
+using compact_utf16le_string = basic_string<unicode::utf16le, compact_inline_bytes>;
+using compact_utf32le_string = basic_string<unicode::utf32le, compact_inline_bytes>;
+
+using compact_string = compact_utf8_string;
+
 } // namespace bigj
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "unicode/detail/count.hpp"
+#include "unicode/detail/transcode.hpp"
+#include "unicode/detail/validate_string.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Iterates over strings stored back to back in a buffer of code units,
+// given the offset of each string followed by the end of the last one. The
+// offsets are trusted to be in order and to fall on code point boundaries.
+template<encoding E, typename Offset>
+struct offset_iterator {
+
+    using code_unit = typename E::code_unit;
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = basic_string_view<E>;
+    using difference_type = ptrdiff_t;
+
+    offset_iterator() noexcept = default;
+
+    offset_iterator(const code_unit* units, const Offset* offset) noexcept
+        : m_units {units}, m_offset {offset} {}
+
+    auto operator*() const noexcept -> value_type {
+        auto sv = basic_string_view<E> {};
+        sv.m_begin = m_units + m_offset[0];
+        sv.m_end = m_units + m_offset[1];
+        return sv;
+    }
+
+    auto operator[](difference_type n) const noexcept -> value_type {
+        return *(*this + n);
+    }
+
+    auto operator++() noexcept -> offset_iterator& {
+        m_offset++;
+        return *this;
+    }
+
+    auto operator++(int) noexcept -> offset_iterator {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    auto operator--() noexcept -> offset_iterator& {
+        m_offset--;
+        return *this;
+    }
+
+    auto operator--(int) noexcept -> offset_iterator {
+        auto tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    auto operator+=(difference_type n) noexcept -> offset_iterator& {
+        m_offset += n;
+        return *this;
+    }
+
+    auto operator-=(difference_type n) noexcept -> offset_iterator& {
+        m_offset -= n;
+        return *this;
+    }
+
+    friend auto operator+(offset_iterator it, difference_type n) noexcept -> offset_iterator {
+        return it += n;
+    }
+
+    friend auto operator+(difference_type n, offset_iterator it) noexcept -> offset_iterator {
+        return it += n;
+    }
+
+    friend auto operator-(offset_iterator it, difference_type n) noexcept -> offset_iterator {
+        return it -= n;
+    }
+
+    friend auto operator-(const offset_iterator& lhs, const offset_iterator& rhs) noexcept -> difference_type {
+        return lhs.m_offset - rhs.m_offset;
+    }
+
+    friend auto operator==(const offset_iterator& lhs, const offset_iterator& rhs) noexcept -> bool {
+        return lhs.m_offset == rhs.m_offset;
+    }
+
+    friend auto operator<=>(const offset_iterator& lhs, const offset_iterator& rhs) noexcept {
+        return lhs.m_offset <=> rhs.m_offset;
+    }
+
+  private:
+    const code_unit* m_units = nullptr;
+    const Offset* m_offset = nullptr;
+};
+
+} // namespace detail
+} // namespace unicode
+
+// Strings of one encoding stored back to back in a single buffer of code
+// units, along with where each of them starts. Elements are handed out as
+// views, which stay valid until the column is modified.
+template<unicode::encoding E>
+struct string_column {
+
+    using encoding_type = E;
+    using code_unit = typename E::code_unit;
+    using const_pointer = const code_unit*;
+    using value_type = basic_string_view<E>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    using const_iterator = unicode::detail::offset_iterator<E, size_type>;
+    using iterator = const_iterator;
+
+    string_column() : m_offsets {0} {}
+
+    template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, basic_string_view<E>>
+    explicit string_column(R&& strings) : string_column {} {
+        append_range(std::forward<R>(strings));
+    }
+
+    // Iterators
+
+    auto begin() const noexcept -> const_iterator {
+        return const_iterator {m_units.data(), m_offsets.data()};
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return const_iterator {m_units.data(), m_offsets.data() + size()};
+    }
+
+    // Element access
+
+    auto operator[](size_type i) const noexcept -> basic_string_view<E> {
+        assert(i < size());
+        return begin()[i];
+    }
+
+    auto at(size_type i) const -> basic_string_view<E> {
+        if (i >= size()) [[unlikely]] {
+            throw std::out_of_range {"index is out of range"};
+        }
+
+        return (*this)[i];
+    }
+
+    auto front() const noexcept -> basic_string_view<E> {
+        return (*this)[0];
+    }
+
+    auto back() const noexcept -> basic_string_view<E> {
+        return (*this)[size() - 1];
+    }
+
+    // The code units of all strings, and the offset of each string into
+    // them followed by the total size.
+
+    auto code_units() const noexcept -> std::span<const code_unit> {
+        return m_units;
+    }
+
+    auto offsets() const noexcept -> std::span<const size_type> {
+        return m_offsets;
+    }
+
+    // Capacity
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return size() == 0;
+    }
+
+    auto size() const noexcept -> size_type {
+        return m_offsets.size() - 1;
+    }
+
+    auto reserve(size_type strings, size_type code_units) -> void {
+        m_offsets.reserve(strings + 1);
+        m_units.reserve(code_units);
+    }
+
+    // Bytes allocated by the column.
+    auto allocated_bytes() const noexcept -> size_type {
+        return sizeof(size_type) * m_offsets.capacity() + sizeof(code_unit) * m_units.capacity();
+    }
+
+    // Modifiers
+
+    auto clear() noexcept -> void {
+        m_units.clear();
+        m_offsets.resize(1);
+    }
+
+    auto push_back(basic_string_view<E> str) -> void {
+        auto units = str.code_units();
+
+        // Growing the offsets first leaves the column unchanged if either
+        // allocation fails.
+        if (m_offsets.size() == m_offsets.capacity()) {
+            m_offsets.reserve(2 * m_offsets.size());
+        }
+
+        m_units.insert(m_units.end(), units.begin(), units.end());
+        m_offsets.push_back(m_units.size());
+    }
+
+    template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, basic_string_view<E>>
+    auto append_range(R&& strings) -> void {
+        if constexpr (std::ranges::sized_range<R>) {
+            m_offsets.reserve(m_offsets.size() + std::ranges::size(strings));
+        }
+
+        for (auto&& str : strings) {
+            push_back(str);
+        }
+    }
+
+    // Appends a batch of strings given as their code units back to back and
+    // the size of each, which must add up to the code units. The whole batch
+    // is validated in a single pass, and each string must end where a code
+    // point does. If an exception is thrown the column is left unchanged.
+    auto append_batch(std::span<const code_unit> units, std::span<const size_type> sizes) -> void {
+        auto begin = units.data();
+        auto end = units.data() + units.size();
+
+        auto total = size_type {0};
+
+        for (auto size : sizes) {
+            if (size > units.size() - total) [[unlikely]] {
+                throw std::invalid_argument {"sizes exceed the code units"};
+            }
+
+            total += size;
+        }
+
+        if (total != units.size()) [[unlikely]] {
+            throw std::invalid_argument {"sizes do not add up to the code units"};
+        }
+
+        unicode::detail::validate_string<E>(begin, end);
+
+        auto it = begin;
+
+        for (auto size : sizes) {
+            it += size;
+
+            if (it != end && unicode::detail::code_point_start<E>(begin, it) != it) [[unlikely]] {
+                throw unicode::parse_error {unicode::error_code::incomplete_sequence};
+            }
+        }
+
+        m_offsets.reserve(m_offsets.size() + sizes.size());
+        m_units.reserve(m_units.size() + units.size());
+
+        for (auto size : sizes) {
+            m_offsets.push_back(m_offsets.back() + size);
+        }
+
+        m_units.insert(m_units.end(), begin, end);
+    }
+
+    // Transcodes every string to another encoding. Columns of more than
+    // parallel_threshold code units are split into contiguous runs of
+    // strings, which are transcoded by up to threads threads at once, or by
+    // as many as the hardware runs concurrently if threads is zero.
+    template<unicode::encoding F>
+    auto transcode(size_type threads = 0) const -> string_column<F> {
+        auto result = string_column<F> {};
+
+        auto count = size();
+        auto total = m_units.size();
+
+        if (count == 0) {
+            return result;
+        }
+
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        auto chunk_count = std::min({threads, count, total / parallel_threshold + 1});
+
+        // The first string of each chunk, and where its code units start in
+        // the result.
+        auto firsts = std::vector<size_type>(chunk_count + 1);
+        auto bases = std::vector<size_type>(chunk_count + 1);
+
+        for (size_type c = 1; c < chunk_count; c++) {
+            auto it = std::ranges::lower_bound(m_offsets, total / chunk_count * c);
+            firsts[c] = std::clamp(static_cast<size_type>(it - m_offsets.begin()), firsts[c - 1], count);
+        }
+
+        firsts[chunk_count] = count;
+        result.m_offsets.resize(count + 1);
+
+        // Each chunk first sizes its strings, counting from its own start.
+        run_chunks(chunk_count, [&](size_type c) {
+            auto offset = size_type {0};
+
+            for (auto i = firsts[c]; i != firsts[c + 1]; i++) {
+                auto units = (*this)[i].code_units();
+                offset += unicode::detail::transcoded_size<F, E>(units.begin(), units.end());
+                result.m_offsets[i + 1] = offset;
+            }
+
+            bases[c + 1] = offset;
+        });
+
+        for (size_type c = 0; c < chunk_count; c++) {
+            bases[c + 1] += bases[c];
+        }
+
+        result.m_units.resize(bases[chunk_count]);
+
+        // Then its strings are transcoded in one go, as they are contiguous
+        // in both columns.
+        run_chunks(chunk_count, [&](size_type c) {
+            for (auto i = firsts[c]; i != firsts[c + 1]; i++) {
+                result.m_offsets[i + 1] += bases[c];
+            }
+
+            auto it = m_units.data() + m_offsets[firsts[c]];
+            auto end = m_units.data() + m_offsets[firsts[c + 1]];
+            auto out = result.m_units.data() + bases[c];
+
+            [[maybe_unused]] auto out_end = unicode::detail::transcode_block<F, E>(
+                it, end, out, out + (bases[c + 1] - bases[c])
+            );
+
+            assert(out_end == out + (bases[c + 1] - bases[c]));
+        });
+
+        return result;
+    }
+
+    static constexpr auto parallel_threshold = size_type {1} << 16;
+
+  private:
+    template<unicode::encoding>
+    friend struct string_column;
+
+    // Runs f for every chunk, all but the first on threads of their own.
+    template<typename F>
+    static auto run_chunks(size_type count, F f) -> void {
+        auto workers = std::vector<std::jthread> {};
+        workers.reserve(count - 1);
+
+        for (size_type c = 1; c < count; c++) {
+            workers.emplace_back(f, c);
+        }
+
+        f(0);
+    }
+
+    std::vector<code_unit> m_units;
+    std::vector<size_type> m_offsets;
+};
+
+} // namespace bigj
@@ -0,0 +1,531 @@
+#pragma once
+
+#include "basic_string.hpp"
+#include "basic_string_view.hpp"
+#include "string_column.hpp"
+#include "unicode/detail/count.hpp"
+#include "unicode/detail/decode.hpp"
+#include "unicode/detail/hash.hpp"
+#include "unicode/detail/validate_string.hpp"
+#include "unicode/encoding_id.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if __has_include(<sys/mman.h>)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace bigj {
+
+// How much of a string table is checked when it is opened. Checking only
+// the header takes constant time but trusts everything else, and is the
+// default. The checksum detects tables that were corrupted since they were
+// written, which makes validating their strings again unnecessary, but it
+// reads the whole table and so every page of a mapped file. A full check
+// also validates every offset and code unit, for tables that were not
+// written by write_string_table().
+enum class string_table_check {
+    header,
+    checksum,
+    full,
+};
+
+// What a string table stores besides its strings.
+struct string_table_options {
+
+    // A hash index over the strings, which find() uses instead of a linear
+    // search.
+    bool hash_index = true;
+
+    // The length of each string in code points and whether it is ASCII.
+    bool lengths = true;
+};
+
+namespace unicode {
+namespace detail {
+
+// A string table is laid out in the byte order of the machine that wrote
+// it, every section starting at a multiple of 8 bytes:
+//
+//   header
+//   offsets     count + 1 uint64_t, where each string starts and the end
+//   code units  unit_count code units
+//   lengths     count uint64_t, code points of each string with the most
+//               significant bit set if it is ASCII
+//   buckets     bucket_count uint64_t, the index of a string plus one, or
+//               zero for an empty bucket, with linear probing
+//
+// Sections are found by their byte position, which is zero for absent
+// optional ones. The checksum is the XXH64 of the header with a zero
+// checksum followed by the remaining size - sizeof(header) bytes.
+struct string_table_header {
+    std::array<char, 8> magic;
+    uint32_t byte_order;
+    uint32_t version;
+    encoding_id encoding;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t count;
+    uint64_t unit_count;
+    uint64_t offsets;
+    uint64_t units;
+    uint64_t lengths;
+    uint64_t buckets;
+    uint64_t bucket_count;
+    uint64_t checksum;
+};
+
+inline constexpr auto string_table_magic = std::array {'B', 'I', 'G', 'J', 'S', 'T', 'B', 'L'};
+inline constexpr auto string_table_version = uint32_t {1};
+inline constexpr auto string_table_byte_order = uint32_t {0x01020304};
+inline constexpr auto string_table_ascii = uint64_t {1} << 63;
+
+inline auto string_table_checksum(const std::byte* data, size_t size) noexcept -> uint64_t {
+    auto header = string_table_header {};
+    std::memcpy(&header, data, sizeof(header));
+    header.checksum = 0;
+
+    auto h = hasher {};
+    h.update(&header, sizeof(header));
+    h.update(data + sizeof(header), size - sizeof(header));
+    return h.finish();
+}
+
+template<encoding E>
+auto string_table_bucket(const typename E::code_unit* begin, const typename E::code_unit* end, uint64_t bucket_count)
+    noexcept -> uint64_t
+{
+    return hash_bytes(begin, sizeof(typename E::code_unit) * (end - begin)) & (bucket_count - 1);
+}
+
+template<encoding E>
+auto is_ascii(const typename E::code_unit* it, const typename E::code_unit* end) noexcept -> bool {
+    for (; it != end; it++) {
+        if (load_unit<E>(it) >= 0x80) return false;
+    }
+
+    return true;
+}
+
+template<encoding E>
+auto serialize_string_table(const string_column<E>& column, string_table_options options)
+    -> std::vector<std::byte>
+{
+    constexpr auto word = sizeof(uint64_t);
+
+    auto count = column.size();
+    auto units = column.code_units();
+    auto header = string_table_header {};
+
+    header.magic = string_table_magic;
+    header.byte_order = string_table_byte_order;
+    header.version = string_table_version;
+    header.encoding = encoding_id_of<E>;
+    header.count = count;
+    header.unit_count = units.size();
+    header.offsets = sizeof(header);
+    header.units = header.offsets + word * (count + 1);
+
+    auto size = header.units + sizeof(typename E::code_unit) * units.size();
+    size = (size + word - 1) / word * word;
+
+    if (options.lengths) {
+        header.lengths = size;
+        size += word * count;
+    }
+
+    if (options.hash_index) {
+        header.bucket_count = std::bit_ceil(2 * count + 1);
+        header.buckets = size;
+        size += word * header.bucket_count;
+    }
+
+    header.size = size;
+
+    auto result = std::vector<std::byte>(size);
+    auto data = result.data();
+
+    for (size_t i = 0; i <= count; i++) {
+        auto offset = static_cast<uint64_t>(column.offsets()[i]);
+        std::memcpy(data + header.offsets + word * i, &offset, word);
+    }
+
+    if (!units.empty()) {
+        std::memcpy(data + header.units, units.data(), sizeof(typename E::code_unit) * units.size());
+    }
+
+    if (options.lengths) {
+        for (size_t i = 0; i < count; i++) {
+            auto str = column[i].code_units();
+            auto length = static_cast<uint64_t>(count_code_points<E>(str.begin(), str.end()));
+            if (is_ascii<E>(str.begin(), str.end())) length |= string_table_ascii;
+            std::memcpy(data + header.lengths + word * i, &length, word);
+        }
+    }
+
+    if (options.hash_index) {
+        auto buckets = std::vector<uint64_t>(header.bucket_count);
+
+        for (size_t i = 0; i < count; i++) {
+            auto str = column[i].code_units();
+            auto bucket = string_table_bucket<E>(str.begin(), str.end(), header.bucket_count);
+
+            while (buckets[bucket]) {
+                bucket = (bucket + 1) & (header.bucket_count - 1);
+            }
+
+            buckets[bucket] = i + 1;
+        }
+
+        std::memcpy(data + header.buckets, buckets.data(), word * buckets.size());
+    }
+
+    std::memcpy(data, &header, sizeof(header));
+    header.checksum = string_table_checksum(data, size);
+    std::memcpy(data, &header, sizeof(header));
+
+    return result;
+}
+
+} // namespace detail
+} // namespace unicode
+
+// Serializes strings and string views of any encoding into a string table
+// of encoding E, which can be written to a file as is.
+template<unicode::encoding E, std::ranges::input_range R>
+    requires unicode::detail::string_like<std::ranges::range_reference_t<R>>
+auto write_string_table(R&& strings, string_table_options options = {}) -> std::vector<std::byte> {
+    if constexpr (std::same_as<std::remove_cvref_t<R>, string_column<E>>) {
+        return unicode::detail::serialize_string_table<E>(strings, options);
+    } else {
+        auto column = string_column<E> {};
+
+        for (auto&& str : strings) {
+            using F = unicode::detail::string_encoding_t<decltype(str)>;
+
+            if constexpr (std::same_as<E, F>) {
+                column.push_back(unicode::detail::as_view(str));
+            } else {
+                column.push_back(basic_string<E> {unicode::detail::as_view(str)});
+            }
+        }
+
+        return unicode::detail::serialize_string_table<E>(column, options);
+    }
+}
+
+// Strings read in place from a string table written by write_string_table(),
+// typically from a memory mapped file. Opening a table only reads its
+// header, and its strings are handed out as views into it.
+template<unicode::encoding E>
+struct string_table {
+
+    using encoding_type = E;
+    using code_unit = typename E::code_unit;
+    using value_type = basic_string_view<E>;
+    using const_iterator = unicode::detail::offset_iterator<E, uint64_t>;
+    using iterator = const_iterator;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    string_table() noexcept = default;
+
+    // Opens the table in bytes, which must stay alive and unchanged while it
+    // is used. The bytes must be aligned to 8 bytes, as the ones of memory
+    // mapped files and of vectors are. Only the header is checked unless
+    // check asks for more.
+    explicit string_table(std::span<const std::byte> bytes, string_table_check check = string_table_check::header) {
+        using header_type = unicode::detail::string_table_header;
+
+        constexpr auto word = sizeof(uint64_t);
+
+        if (bytes.size() < sizeof(header_type)) [[unlikely]] {
+            throw std::invalid_argument {"not a string table"};
+        }
+
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint64_t) != 0) [[unlikely]] {
+            throw std::invalid_argument {"string table is not aligned"};
+        }
+
+        auto header = header_type {};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.magic != unicode::detail::string_table_magic) [[unlikely]] {
+            throw std::invalid_argument {"not a string table"};
+        } else if (header.byte_order != unicode::detail::string_table_byte_order) [[unlikely]] {
+            throw std::invalid_argument {"string table has another byte order"};
+        } else if (header.version != unicode::detail::string_table_version) [[unlikely]] {
+            throw std::invalid_argument {"unsupported string table version"};
+        } else if (header.encoding != unicode::encoding_id_of<E>) [[unlikely]] {
+            throw std::invalid_argument {"string table has another encoding"};
+        } else if (header.size < sizeof(header) || header.size > bytes.size()) [[unlikely]] {
+            throw std::invalid_argument {"string table is truncated"};
+        }
+
+        auto fits = [&](uint64_t position, uint64_t count, uint64_t element_size) {
+            return position % word == 0
+                && position >= sizeof(header)
+                && position <= header.size
+                && count <= (header.size - position) / element_size;
+        };
+
+        if (
+            header.count >= header.size / word
+            || !fits(header.offsets, header.count + 1, word)
+            || !fits(header.units, header.unit_count, sizeof(code_unit))
+            || (header.lengths && !fits(header.lengths, header.count, word))
+            || (header.buckets && !std::has_single_bit(header.bucket_count))
+            || (header.buckets && !fits(header.buckets, header.bucket_count, word))
+        ) [[unlikely]] {
+            throw std::invalid_argument {"string table is corrupted"};
+        }
+
+        auto data = bytes.data();
+
+        m_count = static_cast<size_type>(header.count);
+        m_offsets = reinterpret_cast<const uint64_t*>(data + header.offsets);
+        m_units = reinterpret_cast<const code_unit*>(data + header.units);
+        m_lengths = header.lengths ? reinterpret_cast<const uint64_t*>(data + header.lengths) : nullptr;
+        m_buckets = header.buckets ? reinterpret_cast<const uint64_t*>(data + header.buckets) : nullptr;
+        m_bucket_count = header.buckets ? header.bucket_count : 0;
+
+        if (m_offsets[0] != 0 || m_offsets[m_count] != header.unit_count) [[unlikely]] {
+            throw std::invalid_argument {"string table is corrupted"};
+        }
+
+        if (check != string_table_check::header) {
+            if (unicode::detail::string_table_checksum(data, header.size) != header.checksum) [[unlikely]] {
+                throw std::invalid_argument {"string table checksum does not match"};
+            }
+        }
+
+        if (check == string_table_check::full) {
+            validate_contents();
+        }
+    }
+
+    // Iterators
+
+    auto begin() const noexcept -> const_iterator {
+        return const_iterator {m_units, m_offsets};
+    }
+
+    auto end() const noexcept -> const_iterator {
+        return const_iterator {m_units, m_offsets + m_count};
+    }
+
+    // Element access
+
+    auto operator[](size_type i) const noexcept -> basic_string_view<E> {
+        assert(i < size());
+        return begin()[i];
+    }
+
+    auto at(size_type i) const -> basic_string_view<E> {
+        if (i >= size()) [[unlikely]] {
+            throw std::out_of_range {"index is out of range"};
+        }
+
+        return (*this)[i];
+    }
+
+    auto front() const noexcept -> basic_string_view<E> {
+        return (*this)[0];
+    }
+
+    auto back() const noexcept -> basic_string_view<E> {
+        return (*this)[size() - 1];
+    }
+
+    auto code_units() const noexcept -> std::span<const code_unit> {
+        return {m_units, m_offsets[m_count]};
+    }
+
+    // Length in code points of a string, stored or counted.
+    auto length(size_type i) const noexcept -> size_type {
+        if (m_lengths) {
+            return static_cast<size_type>(m_lengths[i] & ~unicode::detail::string_table_ascii);
+        } else {
+            return (*this)[i].length();
+        }
+    }
+
+    auto is_ascii(size_type i) const noexcept -> bool {
+        if (m_lengths) {
+            return m_lengths[i] & unicode::detail::string_table_ascii;
+        } else {
+            auto units = (*this)[i].code_units();
+            return unicode::detail::is_ascii<E>(units.begin(), units.end());
+        }
+    }
+
+    // Capacity
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_count == 0;
+    }
+
+    auto size() const noexcept -> size_type {
+        return m_count;
+    }
+
+    auto has_lengths() const noexcept -> bool {
+        return m_lengths != nullptr;
+    }
+
+    auto has_hash_index() const noexcept -> bool {
+        return m_buckets != nullptr;
+    }
+
+    // Search
+
+    // Returns the index of the first string equal to str, through the hash
+    // index if the table has one.
+    auto find(basic_string_view<E> str) const noexcept -> std::optional<size_type> {
+        if (m_buckets) {
+            auto units = str.code_units();
+            auto bucket = unicode::detail::string_table_bucket<E>(units.begin(), units.end(), m_bucket_count);
+
+            for (uint64_t n = 0; n < m_bucket_count; n++) {
+                auto entry = m_buckets[bucket];
+
+                if (entry == 0) {
+                    break;
+                } else if (entry <= m_count && (*this)[entry - 1] == str) {
+                    return static_cast<size_type>(entry - 1);
+                }
+
+                bucket = (bucket + 1) & (m_bucket_count - 1);
+            }
+        } else {
+            for (size_type i = 0; i < m_count; i++) {
+                if ((*this)[i] == str) return i;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+  private:
+    auto validate_contents() const -> void {
+        for (size_type i = 0; i < m_count; i++) {
+            if (m_offsets[i] > m_offsets[i + 1]) [[unlikely]] {
+                throw std::invalid_argument {"string table is corrupted"};
+            }
+        }
+
+        auto units = code_units();
+        unicode::detail::validate_string<E>(units.data(), units.data() + units.size());
+
+        for (size_type i = 1; i < m_count; i++) {
+            auto it = m_units + m_offsets[i];
+
+            if (unicode::detail::code_point_start<E>(m_units, it) != it) [[unlikely]] {
+                throw unicode::parse_error {unicode::error_code::incomplete_sequence};
+            }
+        }
+
+        for (size_type i = 0; m_lengths && i < m_count; i++) {
+            auto str = (*this)[i].code_units();
+            auto expected = static_cast<uint64_t>(unicode::detail::count_code_points<E>(str.begin(), str.end()));
+            if (unicode::detail::is_ascii<E>(str.begin(), str.end())) expected |= unicode::detail::string_table_ascii;
+
+            if (m_lengths[i] != expected) [[unlikely]] {
+                throw std::invalid_argument {"string table is corrupted"};
+            }
+        }
+    }
+
+    static constexpr auto no_offsets = std::array<uint64_t, 1> {0};
+
+    const uint64_t* m_offsets = no_offsets.data();
+    const code_unit* m_units = nullptr;
+    const uint64_t* m_lengths = nullptr;
+    const uint64_t* m_buckets = nullptr;
+    size_type m_count = 0;
+    uint64_t m_bucket_count = 0;
+};
+
+#if __has_include(<sys/mman.h>)
+
+// A whole file mapped read only into memory, from which a string table can
+// be opened without reading it. Only available on POSIX systems.
+struct mapped_file {
+
+    mapped_file() noexcept = default;
+
+    explicit mapped_file(const char* path) {
+        auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0) [[unlikely]] {
+            throw std::system_error {errno, std::generic_category(), path};
+        }
+
+        struct stat status;
+
+        if (::fstat(fd, &status) != 0) [[unlikely]] {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error {error, std::generic_category(), path};
+        }
+
+        m_size = static_cast<size_t>(status.st_size);
+
+        if (m_size != 0) {
+            auto data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data == MAP_FAILED) [[unlikely]] {
+                auto error = errno;
+                ::close(fd);
+                throw std::system_error {error, std::generic_category(), path};
+            }
+
+            m_data = data;
+        }
+
+        ::close(fd);
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : m_data {std::exchange(other.m_data, nullptr)}, m_size {std::exchange(other.m_size, 0)} {}
+
+    mapped_file& operator=(mapped_file other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    ~mapped_file() noexcept {
+        if (m_data) ::munmap(m_data, m_size);
+    }
+
+    auto bytes() const noexcept -> std::span<const std::byte> {
+        return {static_cast<const std::byte*>(m_data), m_size};
+    }
+
+  private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+#endif
+
+} // namespace bigj
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "basic_string_view.hpp"
+#include "unicode/detail/transcode.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+#include <cstddef>
+
+namespace bigj {
+
+// Presents a string of encoding F as the code units of E, transcoding them
+// lazily a small block at a time. Being an input range, it can be iterated
+// once, and the string must outlive the view.
+template<unicode::encoding E, unicode::encoding F>
+struct transcode_view : std::ranges::view_interface<transcode_view<E, F>> {
+
+    using code_unit = typename E::code_unit;
+    using size_type = size_t;
+
+    static constexpr auto block_size = size_type {64};
+
+    struct iterator {
+
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = code_unit;
+        using difference_type = ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> value_type {
+            return m_parent->m_block[m_parent->m_pos];
+        }
+
+        auto operator++() noexcept -> iterator& {
+            if (++m_parent->m_pos == m_parent->m_size) m_parent->fill();
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> void {
+            ++*this;
+        }
+
+        friend auto operator==(const iterator& it, std::default_sentinel_t) noexcept -> bool {
+            return it.done();
+        }
+
+      private:
+        friend struct transcode_view;
+
+        explicit iterator(transcode_view* parent) noexcept : m_parent {parent} {}
+
+        auto done() const noexcept -> bool {
+            return m_parent->m_pos == m_parent->m_size;
+        }
+
+        transcode_view* m_parent = nullptr;
+    };
+
+    transcode_view() noexcept = default;
+
+    explicit transcode_view(basic_string_view<F> str) noexcept
+        : m_it {str.code_units().begin()}, m_end {str.code_units().end()} {}
+
+    auto begin() noexcept -> iterator {
+        if (m_pos == m_size) fill();
+        return iterator {this};
+    }
+
+    auto end() const noexcept -> std::default_sentinel_t {
+        return std::default_sentinel;
+    }
+
+    // Counts the code units that are left, which takes a pass over the rest
+    // of the string.
+    auto encoded_size() const noexcept -> size_type {
+        return m_size - m_pos + unicode::detail::transcoded_size<E, F>(m_it, m_end);
+    }
+
+    // Transcodes as many of the code units that are left as fit into out
+    // straight into it, and returns the written part. Iterating or copying
+    // again continues after them, and an empty result means that none are
+    // left. A code point is only split when out is too small to hold it.
+    auto copy_to(std::span<code_unit> out) noexcept -> std::span<code_unit> {
+        auto out_it = std::copy_n(m_block.data() + m_pos, std::min(m_size - m_pos, out.size()), out.data());
+        auto out_end = out.data() + out.size();
+        m_pos += static_cast<size_type>(out_it - out.data());
+
+        if (m_pos == m_size) {
+            out_it = unicode::detail::transcode_block<E, F>(m_it, m_end, out_it, out_end);
+
+            if (out_it == out.data() && out_it != out_end && m_it != m_end) {
+                fill();
+                out_it = std::copy_n(m_block.data(), std::min(m_size, out.size()), out_it);
+                m_pos = static_cast<size_type>(out_it - out.data());
+            }
+        }
+
+        return out.first(static_cast<size_type>(out_it - out.data()));
+    }
+
+  private:
+    auto fill() noexcept -> void {
+        auto block_end = unicode::detail::transcode_block<E, F>(
+            m_it, m_end, m_block.data(), m_block.data() + block_size
+        );
+
+        m_pos = 0;
+        m_size = static_cast<size_type>(block_end - m_block.data());
+    }
+
+    const typename F::code_unit* m_it = nullptr;
+    const typename F::code_unit* m_end = nullptr;
+    std::array<code_unit, block_size> m_block {};
+    size_type m_pos = 0;
+    size_type m_size = 0;
+};
+
+namespace unicode {
+namespace detail {
+
+template<encoding E>
+struct transcode_adaptor {
+
+    template<string_like S>
+    auto operator()(const S& str) const noexcept -> transcode_view<E, string_encoding_t<S>> {
+        return transcode_view<E, string_encoding_t<S>> {as_view(str)};
+    }
+
+    template<string_like S>
+    friend auto operator|(const S& str, const transcode_adaptor& adaptor) noexcept
+        -> transcode_view<E, string_encoding_t<S>>
+    {
+        return adaptor(str);
+    }
+};
+
+} // namespace detail
+} // namespace unicode
+
+namespace views {
+
+// Adapts a string or string view into a range of the code units of E, as
+// in views::transcode<unicode::utf16le>(str) or str | views::transcode<...>.
+template<unicode::encoding E>
+inline constexpr auto transcode = unicode::detail::transcode_adaptor<E> {};
+
+} // namespace views
+
+} // namespace bigj
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace bigj {
 namespace unicode {
 namespace config {
@@ -10,6 +12,50 @@ namespace config {
 
 constexpr bool null_terminators = CPPUNICODE_NULL_TERMINATORS;
 
+// Code units of heap allocated strings start at this alignment and are
+// followed by at least this many readable bytes, so that vectorized code
+// can process them in whole blocks without a scalar epilogue.
+
+#ifndef CPPUNICODE_BLOCK_ALIGNMENT
+    #define CPPUNICODE_BLOCK_ALIGNMENT 64
+#endif
+
+#ifndef CPPUNICODE_BLOCK_PADDING
+    #define CPPUNICODE_BLOCK_PADDING 64
+#endif
+
+constexpr size_t block_alignment = CPPUNICODE_BLOCK_ALIGNMENT;
+constexpr size_t block_padding = CPPUNICODE_BLOCK_PADDING;
+
+// Substrings covering less than this fraction of the block they would share
+// are copied instead, so that they do not keep a much larger block alive.
+
+#ifndef CPPUNICODE_MIN_SHARED_FRACTION
+    #define CPPUNICODE_MIN_SHARED_FRACTION 0
+#endif
+
+constexpr double min_shared_fraction = CPPUNICODE_MIN_SHARED_FRACTION;
+
+// Bytes taken by a string by default, all but one of which hold the code
+// units of small strings inline. Must be compact_inline_bytes, or at least
+// four words and a multiple of the word size.
+
+#ifndef CPPUNICODE_INLINE_BYTES
+    #define CPPUNICODE_INLINE_BYTES (4 * sizeof(void*))
+#endif
+
+constexpr size_t inline_bytes = CPPUNICODE_INLINE_BYTES;
+
+// Counts allocations, references, validation and transcoding at runtime,
+// see unicode::statistics(). Level 2 also records the sizes of new strings.
+
+#ifndef CPPUNICODE_STATISTICS
+    #define CPPUNICODE_STATISTICS 0
+#endif
+
+constexpr bool statistics = CPPUNICODE_STATISTICS >= 1;
+constexpr bool size_histogram = CPPUNICODE_STATISTICS >= 2;
+
 } // namespace config
 } // namespace unicode
 } // namespace bigj
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "detail/decode.hpp"
+#include "encoding.hpp"
+
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+
+#include <cstddef>
+
+namespace bigj {
+namespace unicode {
+
+// Decodes code units into a caller provided buffer one block at a time and
+// yields each block as a span of code points, which is only valid until the
+// next one is decoded. Being an input range, it can be iterated once.
+template<encoding E>
+struct decoded_blocks : std::ranges::view_interface<decoded_blocks<E>> {
+
+    using code_unit = typename E::code_unit;
+
+    struct iterator {
+
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::span<const code_point>;
+        using difference_type = ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        auto operator*() const noexcept -> value_type {
+            return m_parent->m_block;
+        }
+
+        auto operator++() noexcept -> iterator& {
+            m_parent->next();
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> void {
+            ++*this;
+        }
+
+        friend auto operator==(const iterator& it, std::default_sentinel_t) noexcept -> bool {
+            return it.done();
+        }
+
+      private:
+        friend struct decoded_blocks;
+
+        explicit iterator(decoded_blocks* parent) noexcept : m_parent {parent} {}
+
+        auto done() const noexcept -> bool {
+            return m_parent->m_block.empty();
+        }
+
+        decoded_blocks* m_parent = nullptr;
+    };
+
+    decoded_blocks() noexcept = default;
+
+    decoded_blocks(const code_unit* begin, const code_unit* end, std::span<code_point> buffer)
+        : m_it {begin}, m_end {end}, m_buffer {buffer}
+    {
+        if (buffer.empty()) [[unlikely]] {
+            throw std::invalid_argument {"buffer must not be empty"};
+        }
+    }
+
+    auto begin() noexcept -> iterator {
+        next();
+        return iterator {this};
+    }
+
+    auto end() const noexcept -> std::default_sentinel_t {
+        return std::default_sentinel;
+    }
+
+  private:
+    auto next() noexcept -> void {
+        auto block_end = detail::decode_block<E>(
+            m_it, m_end, m_buffer.data(), m_buffer.data() + m_buffer.size()
+        );
+
+        m_block = {m_buffer.data(), block_end};
+    }
+
+    const code_unit* m_it = nullptr;
+    const code_unit* m_end = nullptr;
+    std::span<code_point> m_buffer;
+    std::span<const code_point> m_block;
+};
+
+} // namespace unicode
+} // namespace bigj
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "decode.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Compares the code points of two strings of any encodings. Both sides are
+// decoded in lockstep, a block at a time, and the blocks are compared as
+// plain arrays.
+template<encoding E, encoding F>
+auto compare_code_points(
+    const typename E::code_unit* lhs,
+    const typename E::code_unit* lhs_end,
+    const typename F::code_unit* rhs,
+    const typename F::code_unit* rhs_end
+) noexcept -> std::strong_ordering {
+    auto lhs_block = std::array<uint32_t, 64> {};
+    auto rhs_block = std::array<uint32_t, 64> {};
+
+    auto lhs_it = lhs_block.data();
+    auto lhs_block_end = lhs_it;
+    auto rhs_it = rhs_block.data();
+    auto rhs_block_end = rhs_it;
+
+    while (true) {
+        if (lhs_it == lhs_block_end) {
+            lhs_it = lhs_block.data();
+            lhs_block_end = decode_block<E>(lhs, lhs_end, lhs_it, lhs_it + lhs_block.size());
+        }
+
+        if (rhs_it == rhs_block_end) {
+            rhs_it = rhs_block.data();
+            rhs_block_end = decode_block<F>(rhs, rhs_end, rhs_it, rhs_it + rhs_block.size());
+        }
+
+        if (lhs_it == lhs_block_end || rhs_it == rhs_block_end) {
+            return (lhs_it != lhs_block_end) <=> (rhs_it != rhs_block_end);
+        }
+
+        auto count = std::min(lhs_block_end - lhs_it, rhs_block_end - rhs_it);
+        auto [lhs_mismatch, rhs_mismatch] = std::mismatch(lhs_it, lhs_it + count, rhs_it);
+
+        if (lhs_mismatch != lhs_it + count) {
+            return *lhs_mismatch <=> *rhs_mismatch;
+        }
+
+        lhs_it += count;
+        rhs_it += count;
+    }
+}
+
+// Index of the first byte at which two buffers differ, or size if they are
+// equal. Whole words are compared at a time.
+inline auto mismatch_bytes(const void* lhs, const void* rhs, size_t size) noexcept -> size_t {
+    auto lhs_bytes = static_cast<const std::byte*>(lhs);
+    auto rhs_bytes = static_cast<const std::byte*>(rhs);
+    auto i = size_t {0};
+
+    for (; size - i >= 8; i += 8) {
+        if (auto diff = load_word(lhs_bytes + i) ^ load_word(rhs_bytes + i)) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return i + std::countr_zero(diff) / 8;
+            } else {
+                return i + std::countl_zero(diff) / 8;
+            }
+        }
+    }
+
+    for (; i < size; i++) {
+        if (lhs_bytes[i] != rhs_bytes[i]) return i;
+    }
+
+    return size;
+}
+
+// Maps a code unit to a key whose order matches the order of the code
+// points it belongs to. UTF-16 needs surrogates moved above the rest of the
+// BMP, other encodings already agree with code point order.
+template<encoding E>
+constexpr auto order_key(typename E::code_unit u) noexcept -> uint32_t {
+    if constexpr (utf_traits<E>::bits == 16) {
+        u = load_unit<E>(&u);
+
+        if (u >= 0xE000) {
+            return u - 0x0800;
+        } else if (u >= 0xD800) {
+            return u + 0x2000;
+        } else {
+            return u;
+        }
+    } else {
+        return load_unit<E>(&u);
+    }
+}
+
+// Compares two strings of the same encoding by code point without decoding
+// them, which the built-in encodings allow once the first differing code
+// unit has been found.
+template<encoding E>
+auto compare_code_units(
+    const typename E::code_unit* lhs,
+    const typename E::code_unit* lhs_end,
+    const typename E::code_unit* rhs,
+    const typename E::code_unit* rhs_end
+) noexcept -> std::strong_ordering {
+    if constexpr (utf_traits<E>::bits == 0) {
+        return compare_code_points<E, E>(lhs, lhs_end, rhs, rhs_end);
+    } else {
+        using code_unit = typename E::code_unit;
+
+        auto lhs_size = static_cast<size_t>(lhs_end - lhs);
+        auto rhs_size = static_cast<size_t>(rhs_end - rhs);
+        auto count = std::min(lhs_size, rhs_size);
+
+        if (lhs == rhs) {
+            return lhs_size <=> rhs_size;
+        }
+
+        auto i = mismatch_bytes(lhs, rhs, sizeof(code_unit) * count) / sizeof(code_unit);
+
+        if (i == count) {
+            return lhs_size <=> rhs_size;
+        } else {
+            return order_key<E>(lhs[i]) <=> order_key<E>(rhs[i]);
+        }
+    }
+}
+
+template<encoding E>
+auto equal_code_units(
+    const typename E::code_unit* lhs,
+    const typename E::code_unit* lhs_end,
+    const typename E::code_unit* rhs,
+    const typename E::code_unit* rhs_end
+) noexcept -> bool {
+    auto size = static_cast<size_t>(lhs_end - lhs);
+
+    if (size != static_cast<size_t>(rhs_end - rhs)) {
+        return false;
+    } else if (lhs == rhs) {
+        return true;
+    } else {
+        return mismatch_bytes(lhs, rhs, sizeof(typename E::code_unit) * size)
+            == sizeof(typename E::code_unit) * size;
+    }
+}
+
+template<encoding E, encoding F>
+auto equal_code_points(
+    const typename E::code_unit* lhs,
+    const typename E::code_unit* lhs_end,
+    const typename F::code_unit* rhs,
+    const typename F::code_unit* rhs_end
+) noexcept -> bool {
+    if constexpr (std::same_as<E, F>) {
+        return equal_code_units<E>(lhs, lhs_end, rhs, rhs_end);
+    } else {
+        return compare_code_points<E, F>(lhs, lhs_end, rhs, rhs_end) == 0;
+    }
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "../iterator.hpp"
+#include "decode.hpp"
+#include "search.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Counts the code points of valid code units without decoding them. A code
+// point starts at every UTF-8 unit that is not a continuation byte and at
+// every UTF-16 unit that is not a low surrogate.
+template<encoding E>
+auto count_code_points(const typename E::code_unit* it, const typename E::code_unit* end)
+    noexcept -> size_t
+{
+    constexpr auto bits = utf_traits<E>::bits;
+
+    auto size = static_cast<size_t>(end - it);
+
+    if constexpr (bits == 8) {
+        auto count = size;
+        auto i = size_t {0};
+
+        for (; size - i >= 8; i += 8) {
+            auto word = load_word(it + i);
+            count -= std::popcount(word & ~(word << 1) & 0x8080808080808080);
+        }
+
+        for (; i < size; i++) {
+            count -= (it[i] & 0xC0) == 0x80;
+        }
+
+        return count;
+    } else if constexpr (bits == 16) {
+        using lanes = unit_lanes<typename E::code_unit>;
+
+        // Swapping bytes is its own inverse, so load_unit() also puts the
+        // masks in the byte order of the code units.
+        auto units = std::array<typename E::code_unit, 2> {0xFC00, 0xDC00};
+        auto mask = lanes::broadcast(load_unit<E>(&units[0]));
+        auto low = lanes::broadcast(load_unit<E>(&units[1]));
+        auto count = size;
+        auto i = size_t {0};
+
+        for (; size - i >= lanes::count; i += lanes::count) {
+            count -= std::popcount(lanes::zero_lanes((lanes::load(it + i) & mask) ^ low));
+        }
+
+        for (; i < size; i++) {
+            count -= (load_unit<E>(it + i) & 0xFC00) == 0xDC00;
+        }
+
+        return count;
+    } else if constexpr (bits == 32) {
+        return size;
+    } else {
+        return static_cast<size_t>(std::distance(iterator<E> {it}, iterator<E> {end}));
+    }
+}
+
+// Counts the UTF-16 code units needed to encode valid code units, which is
+// their number of code points plus one for each code point above the BMP.
+template<encoding E>
+auto count_utf16_units(const typename E::code_unit* it, const typename E::code_unit* end)
+    noexcept -> size_t
+{
+    constexpr auto bits = utf_traits<E>::bits;
+
+    auto size = static_cast<size_t>(end - it);
+
+    if constexpr (bits == 8) {
+        auto count = count_code_points<E>(it, end);
+        auto i = size_t {0};
+
+        for (; size - i >= 8; i += 8) {
+            auto word = load_word(it + i);
+            count += std::popcount(word & (word << 1) & (word << 2) & (word << 3) & 0x8080808080808080);
+        }
+
+        for (; i < size; i++) {
+            count += it[i] >= 0xF0;
+        }
+
+        return count;
+    } else if constexpr (bits == 16) {
+        return size;
+    } else if constexpr (bits == 32) {
+        auto count = size;
+
+        for (size_t i = 0; i < size; i++) {
+            count += load_unit<E>(it + i) > 0xFFFF;
+        }
+
+        return count;
+    } else {
+        auto count = size_t {0};
+
+        for (auto cp = iterator<E> {it}; cp != iterator<E> {end}; cp++) {
+            count += *cp > 0xFFFF ? 2 : 1;
+        }
+
+        return count;
+    }
+}
+
+// Skips code points until n of them have been skipped or end is reached,
+// leaving n with the number that could not be. The result is the start of a
+// code point, so with n = 0 this moves to the next code point boundary.
+template<encoding E>
+auto advance_code_points(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    size_t& n
+) noexcept -> const typename E::code_unit* {
+    constexpr auto bits = utf_traits<E>::bits;
+
+    if constexpr (bits == 8) {
+        for (; end - it >= 8; it += 8) {
+            auto word = load_word(it);
+            auto starts = static_cast<size_t>(8 - std::popcount(word & ~(word << 1) & 0x8080808080808080));
+            if (starts > n) break;
+            n -= starts;
+        }
+
+        for (; it != end; it++) {
+            if ((*it & 0xC0) != 0x80) {
+                if (n == 0) break;
+                n--;
+            }
+        }
+
+        return it;
+    } else if constexpr (bits == 16) {
+        using lanes = unit_lanes<typename E::code_unit>;
+
+        auto units = std::array<typename E::code_unit, 2> {0xFC00, 0xDC00};
+        auto mask = lanes::broadcast(load_unit<E>(&units[0]));
+        auto low = lanes::broadcast(load_unit<E>(&units[1]));
+
+        for (; static_cast<size_t>(end - it) >= lanes::count; it += lanes::count) {
+            auto lows = std::popcount(lanes::zero_lanes((lanes::load(it) & mask) ^ low));
+            auto starts = lanes::count - static_cast<size_t>(lows);
+            if (starts > n) break;
+            n -= starts;
+        }
+
+        for (; it != end; it++) {
+            if ((load_unit<E>(it) & 0xFC00) != 0xDC00) {
+                if (n == 0) break;
+                n--;
+            }
+        }
+
+        return it;
+    } else if constexpr (bits == 32) {
+        auto count = std::min(n, static_cast<size_t>(end - it));
+        n -= count;
+        return it + count;
+    } else {
+        auto cp = iterator<E> {it};
+
+        for (; n != 0 && cp != iterator<E> {end}; cp++) {
+            n--;
+        }
+
+        return cp.address();
+    }
+}
+
+// Skips code points until they would have taken n UTF-16 code units, in the
+// same way as advance_code_points(). A code point above the BMP is never
+// split, so n is left with 1 when it would have been.
+template<encoding E>
+auto advance_utf16_units(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    size_t& n
+) noexcept -> const typename E::code_unit* {
+    constexpr auto bits = utf_traits<E>::bits;
+
+    if constexpr (bits == 8) {
+        for (; end - it >= 8; it += 8) {
+            auto word = load_word(it);
+            auto units = 8 - std::popcount(word & ~(word << 1) & 0x8080808080808080)
+                + std::popcount(word & (word << 1) & (word << 2) & (word << 3) & 0x8080808080808080);
+            if (static_cast<size_t>(units) > n) break;
+            n -= units;
+        }
+
+        for (; it != end; it++) {
+            if ((*it & 0xC0) != 0x80) {
+                auto units = size_t {*it >= 0xF0 ? 2u : 1u};
+                if (units > n) break;
+                n -= units;
+            }
+        }
+
+        return it;
+    } else if constexpr (bits == 16) {
+        auto count = std::min(n, static_cast<size_t>(end - it));
+
+        if (count != 0 && it + count != end && (load_unit<E>(it + count) & 0xFC00) == 0xDC00) {
+            count--;
+        }
+
+        n -= count;
+        return it + count;
+    } else {
+        auto cp = iterator<E> {it};
+
+        for (; cp != iterator<E> {end}; cp++) {
+            auto units = size_t {*cp > 0xFFFF ? 2u : 1u};
+            if (units > n) break;
+            n -= units;
+        }
+
+        return cp.address();
+    }
+}
+
+// Returns the start of the code point containing ptr, not looking further
+// back than begin, which must be the start of a code point.
+template<encoding E>
+auto code_point_start(const typename E::code_unit* begin, const typename E::code_unit* ptr)
+    noexcept -> const typename E::code_unit*
+{
+    constexpr auto bits = utf_traits<E>::bits;
+
+    if constexpr (bits == 8) {
+        while (ptr != begin && (*ptr & 0xC0) == 0x80) ptr--;
+        return ptr;
+    } else if constexpr (bits == 16) {
+        return ptr != begin && (load_unit<E>(ptr) & 0xFC00) == 0xDC00 ? ptr - 1 : ptr;
+    } else if constexpr (bits == 32) {
+        return ptr;
+    } else {
+        while (begin != ptr) {
+            auto next = E::next_code_point(begin);
+            if (next > ptr) break;
+            begin = next;
+        }
+
+        return begin;
+    }
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../encoding/utf8.hpp"
+#include "../encoding/utf16.hpp"
+#include "../encoding/utf32.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Code unit width and byte order of the built-in encodings, which lets
+// kernels work on whole runs of code units instead of code points.
+template<typename E>
+struct utf_traits {
+    static constexpr auto bits = 0;
+    static constexpr auto endian = std::endian::native;
+};
+
+template<>
+struct utf_traits<utf8> {
+    static constexpr auto bits = 8;
+    static constexpr auto endian = std::endian::native;
+};
+
+template<std::endian X>
+struct utf_traits<utf16<X>> {
+    static constexpr auto bits = 16;
+    static constexpr auto endian = X;
+};
+
+template<std::endian X>
+struct utf_traits<utf32<X>> {
+    static constexpr auto bits = 32;
+    static constexpr auto endian = X;
+};
+
+// Reads a code unit in native byte order.
+template<encoding E>
+constexpr auto load_unit(const typename E::code_unit* it) noexcept -> typename E::code_unit {
+    if constexpr (utf_traits<E>::bits > 8 && utf_traits<E>::endian != std::endian::native) {
+        return byte_swap(*it);
+    } else {
+        return *it;
+    }
+}
+
+inline auto load_word(const void* it) noexcept -> uint64_t {
+    auto word = uint64_t {};
+    std::memcpy(&word, it, sizeof(word));
+    return word;
+}
+
+// Decodes code points from it into out until either end or out_end is
+// reached and returns the end of the decoded code points. Runs of ASCII in
+// UTF-8 and of BMP code points in UTF-16 are widened eight units at a time.
+template<encoding E, typename T>
+auto decode_block(
+    const typename E::code_unit*& it,
+    const typename E::code_unit* end,
+    T* out,
+    T* out_end
+) noexcept -> T* {
+    constexpr auto bits = utf_traits<E>::bits;
+
+    while (it != end && out != out_end) {
+        if constexpr (bits == 8 || bits == 16) {
+            if (end - it >= 8 && out_end - out >= 8) {
+                auto fast = true;
+
+                if constexpr (bits == 8) {
+                    fast = !(load_word(it) & 0x8080808080808080);
+                } else {
+                    for (auto i = 0; i < 8; i++) {
+                        fast &= (load_unit<E>(it + i) & 0xF800) != 0xD800;
+                    }
+                }
+
+                if (fast) {
+                    for (auto i = 0; i < 8; i++) {
+                        out[i] = load_unit<E>(it + i);
+                    }
+
+                    it += 8;
+                    out += 8;
+                    continue;
+                }
+            }
+        } else if constexpr (bits == 32) {
+            auto count = std::min(end - it, out_end - out);
+
+            for (auto i = 0; i < count; i++) {
+                out[i] = load_unit<E>(it + i);
+            }
+
+            it += count;
+            out += count;
+            continue;
+        }
+
+        *out++ = E::decode_and_advance(it);
+    }
+
+    return out;
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
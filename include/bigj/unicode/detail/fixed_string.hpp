@@ -0,0 +1,32 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include <cstddef>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Character array usable as a template argument, which lets string literal
+// operator templates see the contents of the literal at compile time.
+template<typename CharT, size_t N>
+struct fixed_string {
+
+    using value_type = CharT;
+
+    consteval fixed_string(const CharT (&str)[N]) noexcept {
+        std::copy_n(str, N, chars.begin());
+    }
+
+    constexpr auto size() const noexcept -> size_t {
+        return N - 1;
+    }
+
+    std::array<CharT, N> chars;
+};
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
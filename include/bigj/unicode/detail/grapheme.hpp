@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../code_point.hpp"
+
+#include <array>
+#include <utility>
+
+#include <cstdint>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Approximates extended grapheme cluster boundaries without the Unicode
+// character database. Combining marks of the common blocks, variation
+// selectors, emoji modifiers and tags extend the previous cluster, as does
+// anything joined by a zero width joiner. CR LF and pairs of regional
+// indicators form one cluster each.
+struct grapheme_breaker {
+
+    // Returns whether a cluster starts at cp, given the code points before.
+    constexpr auto is_break(code_point cp) noexcept -> bool {
+        auto prev = m_prev;
+        auto regional_count = m_regional_count;
+
+        m_prev = cp;
+        m_regional_count = is_regional_indicator(cp) ? regional_count + 1 : 0;
+
+        if (!m_started) {
+            m_started = true;
+            return true;
+        } else if (prev == U'\r' && cp == U'\n') {
+            return false;
+        } else if (prev == U'\r' || prev == U'\n' || cp == U'\r' || cp == U'\n') {
+            return true;
+        } else if (is_extend(cp) || cp == zero_width_joiner || prev == zero_width_joiner) {
+            return false;
+        } else if (is_regional_indicator(cp) && regional_count % 2 == 1) {
+            return false;
+        } else {
+            return true;
+        }
+    }
+
+  private:
+    static constexpr auto zero_width_joiner = uint32_t {0x200D};
+
+    static constexpr auto is_regional_indicator(code_point cp) noexcept -> bool {
+        return cp >= 0x1F1E6 && cp <= 0x1F1FF;
+    }
+
+    static constexpr auto is_extend(code_point cp) noexcept -> bool {
+        constexpr auto ranges = std::array<std::pair<uint32_t, uint32_t>, 15> {{
+            {0x0300, 0x036F}, // Combining Diacritical Marks
+            {0x0483, 0x0489}, // Cyrillic combining marks
+            {0x0591, 0x05BD}, // Hebrew points
+            {0x0610, 0x061A}, // Arabic marks
+            {0x064B, 0x065F}, // Arabic harakat
+            {0x0E31, 0x0E3A}, // Thai vowels and tone marks
+            {0x0E47, 0x0E4E},
+            {0x1AB0, 0x1AFF}, // Combining Diacritical Marks Extended
+            {0x1DC0, 0x1DFF}, // Combining Diacritical Marks Supplement
+            {0x20D0, 0x20FF}, // Combining Diacritical Marks for Symbols
+            {0xFE00, 0xFE0F}, // Variation Selectors
+            {0xFE20, 0xFE2F}, // Combining Half Marks
+            {0x1F3FB, 0x1F3FF}, // Emoji modifiers
+            {0xE0020, 0xE007F}, // Tags
+            {0xE0100, 0xE01EF}, // Variation Selectors Supplement
+        }};
+
+        for (auto [first, last] : ranges) {
+            if (cp >= first && cp <= last) return true;
+        }
+
+        return false;
+    }
+
+    uint32_t m_prev = 0;
+    uint32_t m_regional_count = 0;
+    bool m_started = false;
+};
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
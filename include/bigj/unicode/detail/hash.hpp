@@ -0,0 +1,177 @@
+#pragma once
+
+#include "decode.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Streaming XXH64. The four independent lanes of each 32 byte stripe keep
+// the multipliers of a modern CPU busy and leave the loop open to
+// auto-vectorization, while the result does not depend on how the input
+// is split between calls to update().
+struct hasher {
+
+    explicit hasher(uint64_t seed = 0) noexcept
+        : m_lanes {seed + p1 + p2, seed + p2, seed, seed - p1}, m_seed {seed} {}
+
+    auto update(const void* data, size_t size) noexcept -> void {
+        if (size == 0) return;
+
+        auto it = static_cast<const std::byte*>(data);
+        auto end = it + size;
+
+        m_size += size;
+
+        if (m_buffered) {
+            auto count = std::min(size, stripe_size - m_buffered);
+            std::memcpy(m_buffer.data() + m_buffered, it, count);
+            m_buffered += count;
+            it += count;
+
+            if (m_buffered < stripe_size) return;
+
+            consume(m_buffer.data());
+            m_buffered = 0;
+        }
+
+        for (; end - it >= (ptrdiff_t) stripe_size; it += stripe_size) {
+            consume(it);
+        }
+
+        std::memcpy(m_buffer.data(), it, end - it);
+        m_buffered = end - it;
+    }
+
+    auto finish() const noexcept -> uint64_t {
+        auto h = uint64_t {0};
+
+        if (m_size >= stripe_size) {
+            h = std::rotl(m_lanes[0], 1) + std::rotl(m_lanes[1], 7)
+                + std::rotl(m_lanes[2], 12) + std::rotl(m_lanes[3], 18);
+
+            for (auto lane : m_lanes) {
+                h ^= round(0, lane);
+                h = h * p1 + p4;
+            }
+        } else {
+            h = m_seed + p5;
+        }
+
+        h += m_size;
+
+        auto it = m_buffer.data();
+        auto end = it + m_buffered;
+
+        for (; end - it >= 8; it += 8) {
+            h ^= round(0, load<uint64_t>(it));
+            h = std::rotl(h, 27) * p1 + p4;
+        }
+
+        if (end - it >= 4) {
+            h ^= load<uint32_t>(it) * p1;
+            h = std::rotl(h, 23) * p2 + p3;
+            it += 4;
+        }
+
+        for (; it != end; it++) {
+            h ^= static_cast<uint64_t>(*it) * p5;
+            h = std::rotl(h, 11) * p1;
+        }
+
+        h ^= h >> 33;
+        h *= p2;
+        h ^= h >> 29;
+        h *= p3;
+        h ^= h >> 32;
+
+        return h;
+    }
+
+  private:
+
+    static constexpr auto p1 = uint64_t {0x9E3779B185EBCA87};
+    static constexpr auto p2 = uint64_t {0xC2B2AE3D27D4EB4F};
+    static constexpr auto p3 = uint64_t {0x165667B19E3779F9};
+    static constexpr auto p4 = uint64_t {0x85EBCA77C2B2AE63};
+    static constexpr auto p5 = uint64_t {0x27D4EB2F165667C5};
+
+    static constexpr auto stripe_size = size_t {32};
+
+    template<typename T>
+    static auto load(const std::byte* it) noexcept -> uint64_t {
+        auto value = T {};
+        std::memcpy(&value, it, sizeof(T));
+
+        if constexpr (std::endian::native == std::endian::big) {
+            value = byte_swap(value);
+        }
+
+        return value;
+    }
+
+    static constexpr auto round(uint64_t acc, uint64_t input) noexcept -> uint64_t {
+        return std::rotl(acc + input * p2, 31) * p1;
+    }
+
+    auto consume(const std::byte* stripe) noexcept -> void {
+        for (size_t i = 0; i < m_lanes.size(); i++) {
+            m_lanes[i] = round(m_lanes[i], load<uint64_t>(stripe + 8 * i));
+        }
+    }
+
+    std::array<uint64_t, 4> m_lanes;
+    std::array<std::byte, stripe_size> m_buffer {};
+    size_t m_buffered = 0;
+    uint64_t m_size = 0;
+    uint64_t m_seed;
+};
+
+inline auto hash_bytes(const void* data, size_t size, uint64_t seed = 0) noexcept -> uint64_t {
+    auto h = hasher {seed};
+    h.update(data, size);
+    return h.finish();
+}
+
+// Hashes the code points of a string as if it was encoded in UTF-32LE, so
+// that equal strings have equal hashes whatever their encoding.
+template<encoding E>
+auto hash_code_points(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    uint64_t seed = 0
+) noexcept -> uint64_t {
+    if constexpr (utf_traits<E>::bits == 32 && utf_traits<E>::endian == std::endian::little) {
+        return hash_bytes(it, sizeof(uint32_t) * (end - it), seed);
+    } else {
+        auto h = hasher {seed};
+        auto block = std::array<uint32_t, 64> {};
+
+        while (it != end) {
+            auto block_end = decode_block<E>(it, end, block.data(), block.data() + block.size());
+
+            if constexpr (std::endian::native == std::endian::big) {
+                for (auto cp = block.data(); cp != block_end; cp++) {
+                    *cp = byte_swap(*cp);
+                }
+            }
+
+            h.update(block.data(), sizeof(uint32_t) * (block_end - block.data()));
+        }
+
+        return h.finish();
+    }
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "../code_point.hpp"
+#include "../iterator.hpp"
+#include "decode.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Whole words of code units with the first unit in the lowest lane, whatever
+// the byte order of the machine.
+template<typename T>
+struct unit_lanes {
+    static constexpr auto bits = 8 * sizeof(T);
+    static constexpr auto count = sizeof(uint64_t) / sizeof(T);
+    static constexpr auto high = [] {
+        auto mask = uint64_t {0};
+        for (size_t i = 0; i < count; i++) mask |= uint64_t {1} << (bits * i + bits - 1);
+        return mask;
+    }();
+
+    static auto load(const T* it) noexcept -> uint64_t {
+        auto word = uint64_t {};
+        std::memcpy(&word, it, sizeof(word));
+
+        if constexpr (std::endian::native == std::endian::big) {
+            word = byte_swap(word);
+        }
+
+        return word;
+    }
+
+    static auto broadcast(T unit) noexcept -> uint64_t {
+        T units[count];
+        for (auto& u : units) u = unit;
+        return load(units);
+    }
+
+    // Sets the high bit of every lane that is zero, and no other bit.
+    static constexpr auto zero_lanes(uint64_t word) noexcept -> uint64_t {
+        return ~(((word & ~high) + ~high) | word | ~high);
+    }
+};
+
+// Finds the first occurrence of a needle of code units in a haystack and
+// returns its address, or nullptr if there is none. Valid UTF-8 and UTF-16
+// never contain a valid needle at an offset that is not a code point
+// boundary, so no decoding is needed. Candidate positions are those where
+// both the first and the last unit of the needle match, which are found a
+// word of units at a time and then checked in full.
+template<typename T>
+auto find_units(const T* it, const T* end, const T* needle, const T* needle_end)
+    noexcept -> const T*
+{
+    using lanes = unit_lanes<T>;
+
+    auto size = static_cast<size_t>(end - it);
+    auto needle_size = static_cast<size_t>(needle_end - needle);
+
+    if (needle_size == 0) return it;
+    if (needle_size > size) return nullptr;
+
+    auto matches = [&](size_t i) {
+        return std::memcmp(it + i, needle, sizeof(T) * needle_size) == 0;
+    };
+
+    auto positions = size - needle_size + 1;
+    auto first = lanes::broadcast(needle[0]);
+    auto last = lanes::broadcast(needle[needle_size - 1]);
+    auto i = size_t {0};
+
+    for (; positions - i >= lanes::count; i += lanes::count) {
+        auto mask = lanes::zero_lanes(lanes::load(it + i) ^ first)
+            & lanes::zero_lanes(lanes::load(it + i + needle_size - 1) ^ last);
+
+        for (; mask; mask &= mask - 1) {
+            auto j = i + std::countr_zero(mask) / lanes::bits;
+            if (matches(j)) return it + j;
+        }
+    }
+
+    for (; i < positions; i++) {
+        if (it[i] == needle[0] && matches(i)) return it + i;
+    }
+
+    return nullptr;
+}
+
+// Finds the last occurrence of a needle in the same way as find_units().
+template<typename T>
+auto rfind_units(const T* it, const T* end, const T* needle, const T* needle_end)
+    noexcept -> const T*
+{
+    using lanes = unit_lanes<T>;
+
+    auto size = static_cast<size_t>(end - it);
+    auto needle_size = static_cast<size_t>(needle_end - needle);
+
+    if (needle_size == 0) return end;
+    if (needle_size > size) return nullptr;
+
+    auto matches = [&](size_t i) {
+        return std::memcmp(it + i, needle, sizeof(T) * needle_size) == 0;
+    };
+
+    auto first = lanes::broadcast(needle[0]);
+    auto last = lanes::broadcast(needle[needle_size - 1]);
+    auto positions = size - needle_size + 1;
+
+    for (; positions >= lanes::count; positions -= lanes::count) {
+        auto i = positions - lanes::count;
+        auto mask = lanes::zero_lanes(lanes::load(it + i) ^ first)
+            & lanes::zero_lanes(lanes::load(it + i + needle_size - 1) ^ last);
+
+        while (mask) {
+            auto bit = 63 - std::countl_zero(mask);
+            auto j = i + bit / lanes::bits;
+            if (matches(j)) return it + j;
+            mask ^= uint64_t {1} << bit;
+        }
+    }
+
+    while (positions--) {
+        if (it[positions] == needle[0] && matches(positions)) return it + positions;
+    }
+
+    return nullptr;
+}
+
+// Counts the non-overlapping occurrences of a needle. Single code unit
+// needles are counted a word at a time.
+template<typename T>
+auto count_units(const T* it, const T* end, const T* needle, const T* needle_end)
+    noexcept -> size_t
+{
+    using lanes = unit_lanes<T>;
+
+    auto size = static_cast<size_t>(end - it);
+    auto needle_size = static_cast<size_t>(needle_end - needle);
+    auto count = size_t {0};
+
+    if (needle_size == 1) {
+        auto unit = lanes::broadcast(*needle);
+        auto i = size_t {0};
+
+        for (; size - i >= lanes::count; i += lanes::count) {
+            count += std::popcount(lanes::zero_lanes(lanes::load(it + i) ^ unit));
+        }
+
+        for (; i < size; i++) {
+            count += it[i] == *needle;
+        }
+    } else {
+        while (auto match = find_units(it, end, needle, needle_end)) {
+            count++;
+            it = match + needle_size;
+        }
+    }
+
+    return count;
+}
+
+// The code units of a single code point, to be searched for as a needle.
+// Values that are not Unicode scalar values can't occur in a valid string
+// and encode to no code units at all.
+template<encoding E>
+struct encoded_code_point {
+
+    explicit constexpr encoded_code_point(code_point cp) noexcept {
+        if (cp <= 0x10FFFF && !(cp >= 0xD800 && cp <= 0xDFFF) && E::encoded_size(cp) <= m_units.size()) {
+            m_size = E::encode(cp, m_units.data()) - m_units.data();
+        }
+    }
+
+    constexpr auto begin() const noexcept -> const typename E::code_unit* {
+        return m_units.data();
+    }
+
+    constexpr auto end() const noexcept -> const typename E::code_unit* {
+        return m_units.data() + m_size;
+    }
+
+    constexpr auto size() const noexcept -> size_t {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+        return m_size == 0;
+    }
+
+  private:
+    std::array<typename E::code_unit, 4> m_units {};
+    size_t m_size = 0;
+};
+
+// Searches by code unit where the encoding is known to be self-synchronizing
+// and by code point otherwise.
+template<encoding E>
+auto find_string(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    const typename E::code_unit* needle,
+    const typename E::code_unit* needle_end
+) noexcept -> const typename E::code_unit* {
+    if constexpr (utf_traits<E>::bits != 0) {
+        return find_units(it, end, needle, needle_end);
+    } else {
+        auto match = std::ranges::search(
+            iterator<E> {it}, iterator<E> {end},
+            iterator<E> {needle}, iterator<E> {needle_end}
+        );
+
+        return match.begin() == iterator<E> {end} && needle != needle_end
+            ? nullptr : match.begin().address();
+    }
+}
+
+template<encoding E>
+auto rfind_string(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    const typename E::code_unit* needle,
+    const typename E::code_unit* needle_end
+) noexcept -> const typename E::code_unit* {
+    if constexpr (utf_traits<E>::bits != 0) {
+        return rfind_units(it, end, needle, needle_end);
+    } else {
+        auto match = std::ranges::find_end(
+            iterator<E> {it}, iterator<E> {end},
+            iterator<E> {needle}, iterator<E> {needle_end}
+        );
+
+        return match.begin() == iterator<E> {end} && needle != needle_end
+            ? nullptr : match.begin().address();
+    }
+}
+
+template<encoding E>
+auto count_string(
+    const typename E::code_unit* it,
+    const typename E::code_unit* end,
+    const typename E::code_unit* needle,
+    const typename E::code_unit* needle_end
+) noexcept -> size_t {
+    if constexpr (utf_traits<E>::bits != 0) {
+        return count_units(it, end, needle, needle_end);
+    } else {
+        auto count = size_t {0};
+
+        while (auto match = find_string<E>(it, end, needle, needle_end)) {
+            count++;
+            it = match + (needle_end - needle);
+        }
+
+        return count;
+    }
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
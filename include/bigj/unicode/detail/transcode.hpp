@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../statistics.hpp"
+#include "count.hpp"
+#include "decode.hpp"
+
+#include <algorithm>
+#include <concepts>
+
+#include <cstddef>
+
+namespace bigj {
+namespace unicode {
+namespace detail {
+
+// Counts the code units of E needed to encode valid code units of F.
+template<encoding E, encoding F>
+auto transcoded_size(const typename F::code_unit* it, const typename F::code_unit* end)
+    noexcept -> size_t
+{
+    constexpr auto to = utf_traits<E>::bits;
+    constexpr auto from = utf_traits<F>::bits;
+
+    if constexpr (std::same_as<E, F> || (to != 0 && to == from)) {
+        return static_cast<size_t>(end - it);
+    } else if constexpr (to == 32 && from != 0) {
+        return count_code_points<F>(it, end);
+    } else if constexpr (to == 16 && from != 0) {
+        return count_utf16_units<F>(it, end);
+    } else if constexpr (to == 8 && from == 16) {
+        auto count = size_t {0};
+
+        // A surrogate pair takes four bytes, two for each of its halves.
+        for (; it != end; it++) {
+            auto unit = load_unit<F>(it);
+            count += unit < 0x80 ? 1 : unit < 0x800 || (unit & 0xF800) == 0xD800 ? 2 : 3;
+        }
+
+        return count;
+    } else {
+        auto count = size_t {0};
+
+        while (it != end) {
+            count += E::encoded_size(F::decode_and_advance(it));
+        }
+
+        return count;
+    }
+}
+
+// Transcodes valid code units of F from it into out until either end is
+// reached or the next code point does not fit before out_end, and returns
+// the end of the written code units. Code units are copied as they are
+// between encodings of the same layout, and runs of ASCII in UTF-8 and of
+// BMP code points in UTF-16 are converted eight units at a time.
+template<encoding E, encoding F>
+auto transcode_block(
+    const typename F::code_unit*& it,
+    const typename F::code_unit* end,
+    typename E::code_unit* out,
+    typename E::code_unit* out_end
+) noexcept -> typename E::code_unit* {
+    constexpr auto to = utf_traits<E>::bits;
+    constexpr auto from = utf_traits<F>::bits;
+
+    auto begin = it;
+
+    auto count_bytes = [&] {
+        record(statistic::transcoded_bytes, sizeof(typename F::code_unit) * (it - begin));
+    };
+
+    if constexpr (std::same_as<E, F> && from != 0) {
+        auto stop = it + std::min(end - it, out_end - out);
+        if (stop != end) stop = code_point_start<F>(it, stop);
+
+        out = std::copy(it, stop, out);
+        it = stop;
+        count_bytes();
+        return out;
+    }
+
+    while (it != end) {
+        if constexpr ((from == 8 || from == 16) && to != 0) {
+            if (end - it >= 8 && out_end - out >= 8) {
+                auto fast = true;
+
+                if constexpr (from == 8) {
+                    fast = !(load_word(it) & 0x8080808080808080);
+                } else {
+                    for (auto i = 0; i < 8; i++) {
+                        auto unit = load_unit<F>(it + i);
+                        fast &= to == 8 ? unit < 0x80 : (unit & 0xF800) != 0xD800;
+                    }
+                }
+
+                if (fast) {
+                    for (auto i = 0; i < 8; i++) {
+                        out = E::encode(load_unit<F>(it + i), out);
+                    }
+
+                    it += 8;
+                    continue;
+                }
+            }
+        }
+
+        auto next = it;
+        auto cp = F::decode_and_advance(next);
+
+        if (E::encoded_size(cp) > static_cast<size_t>(out_end - out)) break;
+
+        out = E::encode(cp, out);
+        it = next;
+    }
+
+    count_bytes();
+    return out;
+}
+
+} // namespace detail
+} // namespace unicode
+} // namespace bigj
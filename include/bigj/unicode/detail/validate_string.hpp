@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../encoding.hpp"
+#include "../statistics.hpp"
 #include "exceptions.hpp"
 
+#include <type_traits>
+
 namespace bigj {
 namespace unicode {
 namespace detail {
@@ -12,6 +15,10 @@ constexpr auto validate_string(
     const typename E::code_unit* begin,
     const typename E::code_unit* end
 ) -> void {
+    if (!std::is_constant_evaluated()) {
+        record(statistic::validated_bytes, sizeof(typename E::code_unit) * (end - begin));
+    }
+
     for (auto it = begin; it != end; it = E::next_code_point(it)) {
         auto ec = E::validate(it, end);
 
@@ -23,6 +30,22 @@ constexpr auto validate_string(
     }
 }
 
+// Returns the start of the first invalid code point, or end if there is
+// none.
+template<encoding E>
+constexpr auto find_invalid(
+    const typename E::code_unit* begin,
+    const typename E::code_unit* end
+) noexcept -> const typename E::code_unit* {
+    auto it = begin;
+
+    while (it != end && E::validate(it, end) == unicode::error_code::ok) {
+        it = E::next_code_point(it);
+    }
+
+    return it;
+}
+
 } // namespace detail
 } // namespace unicode
 } // namespace bigj
@@ -21,6 +21,7 @@ concept encoding =
         { T::encoded_size(value) } noexcept -> std::same_as<size_t>;
         { T::encode(value, output_it) } noexcept -> std::same_as<decltype(output_it)>;
         { T::decode(input_it) } noexcept -> std::same_as<code_point>;
+        { T::decode_and_advance(input_it) } noexcept -> std::same_as<code_point>;
         { T::validate(input_it, end_it) } noexcept -> std::same_as<error_code>;
         { T::next_code_point(input_it) } noexcept -> std::same_as<decltype(input_it)>;
         { T::prev_code_point(input_it) } noexcept -> std::same_as<decltype(input_it)>;
@@ -43,6 +43,18 @@ struct utf16 {
         }
     }
 
+    static constexpr auto decode_and_advance(const_pointer& it) noexcept -> code_point {
+        if (auto w1 = swap_endian(*it++); w1 < 0xD800 || w1 > 0xDFFF) {
+            return w1;
+        } else [[unlikely]] {
+            auto w2 = swap_endian(*it++);
+
+            return (static_cast<code_point>(w1 & 0x03FF) << 10
+                | static_cast<code_point>(w2 & 0x03FF))
+                + 0x010000;
+        }
+    }
+
     static constexpr auto validate(
         const_pointer it,
         const_pointer end
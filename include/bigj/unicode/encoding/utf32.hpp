@@ -28,6 +28,10 @@ struct utf32 {
         return swap_endian(*it);
     }
 
+    static constexpr auto decode_and_advance(const_pointer& it) noexcept -> code_point {
+        return swap_endian(*it++);
+    }
+
     static constexpr auto validate(
         const_pointer it,
         const_pointer
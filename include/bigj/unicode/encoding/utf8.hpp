@@ -69,6 +69,36 @@ struct utf8 {
         }
     }
 
+    // Decodes the code point at it and moves it past the code point, reading
+    // the leading code unit only once.
+    static constexpr auto decode_and_advance(const_pointer& it) noexcept -> code_point {
+        if (auto lead = *it++; lead <= 0x7F) {
+            return lead;
+        } else [[unlikely]] {
+            auto length = std::countl_one(lead);
+
+            if (length == 2) {
+                auto cp = static_cast<code_point>(lead & 0x1F) << 6
+                    | static_cast<code_point>(it[0] & 0x3F);
+                it += 1;
+                return cp;
+            } else if (length == 3) {
+                auto cp = static_cast<code_point>(lead & 0x0F) << 12
+                    | static_cast<code_point>(it[0] & 0x3F) << 6
+                    | static_cast<code_point>(it[1] & 0x3F);
+                it += 2;
+                return cp;
+            } else {
+                auto cp = static_cast<code_point>(lead & 0x07) << 18
+                    | static_cast<code_point>(it[0] & 0x3F) << 12
+                    | static_cast<code_point>(it[1] & 0x3F) << 6
+                    | static_cast<code_point>(it[2] & 0x3F);
+                it += 3;
+                return cp;
+            }
+        }
+    }
+
     static constexpr auto validate(
         const_pointer it,
         const_pointer end
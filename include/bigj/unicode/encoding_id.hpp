@@ -0,0 +1,87 @@
+#pragma once
+
+#include "detail/decode.hpp"
+#include "encoding/utf8.hpp"
+#include "encoding/utf16.hpp"
+#include "encoding/utf32.hpp"
+#include "encoding.hpp"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include <cstdint>
+
+namespace bigj {
+namespace unicode {
+
+// Identifies the encodings of the library at runtime. The values are stable,
+// as they are stored in serialized data.
+enum class encoding_id : uint32_t {
+    utf8 = 1,
+    utf16le = 2,
+    utf16be = 3,
+    utf32le = 4,
+    utf32be = 5,
+};
+
+inline constexpr auto encoding_ids = std::array {
+    encoding_id::utf8,
+    encoding_id::utf16le,
+    encoding_id::utf16be,
+    encoding_id::utf32le,
+    encoding_id::utf32be,
+};
+
+constexpr auto to_string(encoding_id id) noexcept -> std::string_view {
+    switch (id) {
+        case encoding_id::utf8: return "UTF-8";
+        case encoding_id::utf16le: return "UTF-16LE";
+        case encoding_id::utf16be: return "UTF-16BE";
+        case encoding_id::utf32le: return "UTF-32LE";
+        case encoding_id::utf32be: return "UTF-32BE";
+        default: return "unknown";
+    }
+}
+
+namespace detail {
+
+template<encoding E>
+constexpr auto make_encoding_id() noexcept -> encoding_id {
+    constexpr auto bits = utf_traits<E>::bits;
+    constexpr auto little = utf_traits<E>::endian == std::endian::little;
+
+    if constexpr (bits == 8) {
+        return encoding_id::utf8;
+    } else if constexpr (bits == 16) {
+        return little ? encoding_id::utf16le : encoding_id::utf16be;
+    } else {
+        return little ? encoding_id::utf32le : encoding_id::utf32be;
+    }
+}
+
+// Calls f with std::type_identity<E> for the encoding E identified by id,
+// dispatching to code specialized for each encoding.
+template<typename F>
+constexpr auto visit_encoding(encoding_id id, F&& f) -> decltype(auto) {
+    switch (id) {
+        case encoding_id::utf8: return f(std::type_identity<utf8> {});
+        case encoding_id::utf16le: return f(std::type_identity<utf16le> {});
+        case encoding_id::utf16be: return f(std::type_identity<utf16be> {});
+        case encoding_id::utf32le: return f(std::type_identity<utf32le> {});
+        case encoding_id::utf32be: return f(std::type_identity<utf32be> {});
+    }
+
+    throw std::invalid_argument {"unknown encoding"};
+}
+
+} // namespace detail
+
+template<encoding E>
+    requires (detail::utf_traits<E>::bits != 0)
+inline constexpr auto encoding_id_of = detail::make_encoding_id<E>();
+
+} // namespace unicode
+} // namespace bigj
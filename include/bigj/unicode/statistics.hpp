@@ -0,0 +1,206 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bigj {
+namespace unicode {
+
+// What strings did at runtime, summed over every thread. All counts stay
+// zero unless CPPUNICODE_STATISTICS is defined to 1, or to 2 to also record
+// the sizes of new strings.
+struct statistics_snapshot {
+
+    // Strings stored inline, and blocks allocated on the heap with their
+    // total size in bytes, headers and padding included.
+    uint64_t small_strings = 0;
+    uint64_t large_allocations = 0;
+    uint64_t allocated_bytes = 0;
+
+    // Copies and substrings sharing a block, and strings letting go of one.
+    // The last of them frees the block.
+    uint64_t shared_references = 0;
+    uint64_t released_references = 0;
+    uint64_t freed_blocks = 0;
+
+    // Bytes of code units validated, and read by transcoding.
+    uint64_t validated_bytes = 0;
+    uint64_t transcoded_bytes = 0;
+
+    // Calls to length() on heap allocated strings, which either return the
+    // cached length or count the code points and cache them.
+    uint64_t length_cache_hits = 0;
+    uint64_t length_cache_misses = 0;
+
+    // New strings by size in bytes, where bucket i counts sizes of i bits,
+    // that is from 2^(i - 1) up to 2^i - 1, and bucket 0 empty strings.
+    std::array<uint64_t, 65> size_histogram {};
+};
+
+namespace detail {
+
+enum class statistic : size_t {
+    small_strings,
+    large_allocations,
+    allocated_bytes,
+    shared_references,
+    released_references,
+    freed_blocks,
+    validated_bytes,
+    transcoded_bytes,
+    length_cache_hits,
+    length_cache_misses,
+    size_histogram,
+};
+
+inline constexpr auto statistic_count = static_cast<size_t>(statistic::size_histogram) + 65;
+
+using statistic_values = std::array<uint64_t, statistic_count>;
+
+struct thread_statistics;
+
+// Set once the counters of a thread are gone, as strings with thread
+// storage duration may still be destroyed afterwards.
+inline thread_local bool thread_statistics_retired = false;
+
+// Every live thread that has counted something, and what exited threads
+// counted before they did.
+struct statistics_registry {
+    std::mutex mutex;
+    std::vector<thread_statistics*> threads;
+    statistic_values retired {};
+};
+
+inline auto global_statistics() -> statistics_registry& {
+    static auto registry = statistics_registry {};
+    return registry;
+}
+
+// Counters only written by their own thread, so that counting is a plain
+// relaxed load and store without any contention. Other threads only read
+// them to take snapshots.
+struct thread_statistics {
+
+    thread_statistics() {
+        auto& registry = global_statistics();
+        auto lock = std::lock_guard {registry.mutex};
+        registry.threads.push_back(this);
+    }
+
+    thread_statistics(const thread_statistics&) = delete;
+
+    ~thread_statistics() {
+        auto& registry = global_statistics();
+        auto lock = std::lock_guard {registry.mutex};
+
+        std::erase(registry.threads, this);
+        add_to(registry.retired);
+        thread_statistics_retired = true;
+    }
+
+    auto add(size_t index, uint64_t n) noexcept -> void {
+        auto& counter = m_counters[index];
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    auto add_to(statistic_values& values) const noexcept -> void {
+        for (size_t i = 0; i < statistic_count; i++) {
+            values[i] += m_counters[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    auto reset() noexcept -> void {
+        for (auto& counter : m_counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, statistic_count> m_counters {};
+};
+
+inline auto add_statistic(size_t index, uint64_t n) noexcept -> void {
+    thread_local auto counters = thread_statistics {};
+    if (!thread_statistics_retired) counters.add(index, n);
+}
+
+inline auto record(statistic stat, uint64_t n = 1) noexcept -> void {
+    if constexpr (config::statistics) {
+        add_statistic(static_cast<size_t>(stat), n);
+    }
+}
+
+inline auto record_new_string(size_t bytes) noexcept -> void {
+    if constexpr (config::size_histogram) {
+        auto bucket = static_cast<size_t>(std::bit_width(bytes));
+        add_statistic(static_cast<size_t>(statistic::size_histogram) + bucket, 1);
+    }
+}
+
+} // namespace detail
+
+// Sums the counters of every thread. Counts made by other threads while the
+// snapshot is taken may or may not be included.
+inline auto statistics() -> statistics_snapshot {
+    auto values = detail::statistic_values {};
+
+    if constexpr (config::statistics) {
+        auto& registry = detail::global_statistics();
+        auto lock = std::lock_guard {registry.mutex};
+
+        values = registry.retired;
+
+        for (auto thread : registry.threads) {
+            thread->add_to(values);
+        }
+    }
+
+    auto value = [&](detail::statistic stat) {
+        return values[static_cast<size_t>(stat)];
+    };
+
+    auto snapshot = statistics_snapshot {
+        value(detail::statistic::small_strings),
+        value(detail::statistic::large_allocations),
+        value(detail::statistic::allocated_bytes),
+        value(detail::statistic::shared_references),
+        value(detail::statistic::released_references),
+        value(detail::statistic::freed_blocks),
+        value(detail::statistic::validated_bytes),
+        value(detail::statistic::transcoded_bytes),
+        value(detail::statistic::length_cache_hits),
+        value(detail::statistic::length_cache_misses),
+    };
+
+    for (size_t i = 0; i < snapshot.size_histogram.size(); i++) {
+        snapshot.size_histogram[i] = values[static_cast<size_t>(detail::statistic::size_histogram) + i];
+    }
+
+    return snapshot;
+}
+
+// Sets every counter back to zero. Counts made by other threads meanwhile
+// may be lost.
+inline auto reset_statistics() -> void {
+    if constexpr (config::statistics) {
+        auto& registry = detail::global_statistics();
+        auto lock = std::lock_guard {registry.mutex};
+
+        registry.retired = {};
+
+        for (auto thread : registry.threads) {
+            thread->reset();
+        }
+    }
+}
+
+} // namespace unicode
+} // namespace bigj
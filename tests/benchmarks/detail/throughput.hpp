@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+// The amount of text processed by one run of the next benchmark, from which
+// the throughput listener derives bytes and code points per second.
+struct workload {
+    size_t bytes = 0;
+    size_t code_points = 0;
+};
+
+inline auto current_workload = workload {};
+
+inline auto set_workload(size_t bytes, size_t code_points) -> void {
+    current_workload = workload {bytes, code_points};
+}
@@ -0,0 +1,56 @@
+#include "../src/detail/corpus_generator.hpp"
+#include "detail/throughput.hpp"
+
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+#include <string>
+
+using namespace bigj;
+
+static constexpr auto length = size_t {1 << 16};
+
+template<unicode::encoding E>
+static auto search_benchmarks(const std::string& encoding) -> void {
+    for (auto profile : language_profiles) {
+        auto name = encoding + " " + to_string(profile);
+        auto data = corpus_string<E>(profile, length);
+        auto str = basic_string<E> {data.data(), data.data() + data.size()};
+        auto copy = basic_string<E> {str.code_units().begin(), str.code_units().end()};
+        auto needle = basic_string<E> {basic_string_view<E> {str}.substring(
+            std::prev(str.end(), 8), str.end()
+        )};
+
+        set_workload(str.size() * sizeof(typename E::code_unit), length);
+
+        BENCHMARK("hash " + name) {
+            return std::hash<basic_string<E>> {}(str);
+        };
+
+        BENCHMARK("equality " + name) {
+            return str == copy;
+        };
+
+        BENCHMARK("ordering " + name) {
+            return str <=> copy;
+        };
+
+        BENCHMARK("find " + name) {
+            return str.find(needle);
+        };
+
+        BENCHMARK("count " + name) {
+            return str.count(U' ');
+        };
+    }
+}
+
+TEST_CASE("Search and comparison throughput", "[search]") {
+    search_benchmarks<unicode::utf8>("utf8");
+    search_benchmarks<unicode::utf16le>("utf16le");
+    search_benchmarks<unicode::utf32le>("utf32le");
+}
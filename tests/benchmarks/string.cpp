@@ -0,0 +1,351 @@
+#include "../src/detail/corpus_generator.hpp"
+#include "detail/throughput.hpp"
+
+#include <bigj/any_string.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_column.hpp>
+#include <bigj/string_table.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+using namespace bigj;
+
+static constexpr auto large_length = size_t {1 << 16};
+
+template<unicode::encoding E>
+static auto string_benchmarks(const std::string& encoding) -> void {
+    for (auto profile : language_profiles) {
+        auto name = encoding + " " + to_string(profile);
+        auto data = corpus_string<E>(profile, large_length);
+        auto str = basic_string<E> {data.data(), data.data() + data.size()};
+        auto units = str.code_units();
+        auto bytes = units.size() * sizeof(typename E::code_unit);
+        auto sv = basic_string_view<E> {str};
+
+        set_workload(bytes, large_length);
+
+        BENCHMARK("validation " + name) {
+            return unicode::detail::validate_string<E>(units.begin(), units.end());
+        };
+
+        BENCHMARK("construction " + name) {
+            return basic_string<E> {units.begin(), units.end()};
+        };
+
+        BENCHMARK("length " + name) {
+            return sv.length();
+        };
+
+        BENCHMARK("iteration " + name) {
+            auto sum = uint32_t {0};
+            for (auto cp : sv) sum += cp;
+            return sum;
+        };
+
+        BENCHMARK("reverse iteration " + name) {
+            auto sum = uint32_t {0};
+            for (auto it = sv.rbegin(); it != sv.rend(); it++) sum += *it;
+            return sum;
+        };
+
+        set_workload(bytes / 2, large_length / 2);
+
+        BENCHMARK("substring " + name) {
+            return str.substring(std::next(str.begin(), large_length / 4), std::prev(str.end(), large_length / 4));
+        };
+
+        BENCHMARK("substring copy " + name) {
+            return str.substring_copy(std::next(str.begin(), large_length / 4), std::prev(str.end(), large_length / 4));
+        };
+    }
+}
+
+TEST_CASE("String throughput", "[string]") {
+    string_benchmarks<unicode::utf8>("utf8");
+    string_benchmarks<unicode::utf16le>("utf16le");
+    string_benchmarks<unicode::utf32le>("utf32le");
+}
+
+TEST_CASE("String construction and copies", "[string]") {
+    for (auto length : {size_t {4}, size_t {16}, size_t {64}, size_t {1024}}) {
+        auto name = "utf8 latin1_european " + std::to_string(length);
+        auto data = corpus_string<unicode::utf8>(language_profile::latin1_european, length);
+        auto str = string {data.data(), data.data() + data.size()};
+        auto units = str.code_units();
+
+        set_workload(units.size(), length);
+
+        BENCHMARK("construction " + name) {
+            return string {units.begin(), units.end()};
+        };
+
+        BENCHMARK("copy " + name) {
+            return string {str};
+        };
+
+        BENCHMARK("copy and destruction " + name) {
+            auto copy = str;
+            return copy.size();
+        };
+    }
+}
+
+// A table of keys mostly a little longer than the default inline capacity,
+// built and then scanned. Larger strings allocate less, smaller ones touch
+// less memory while scanning.
+template<size_t InlineBytes>
+static auto inline_capacity_benchmarks(const std::vector<std::vector<unicode::utf8::code_unit>>& keys) -> void {
+    using string_type = basic_string<unicode::utf8, InlineBytes>;
+
+    auto name = std::to_string(sizeof(string_type)) + " bytes";
+    auto bytes = size_t {0};
+    auto code_points = size_t {0};
+
+    for (auto& key : keys) {
+        bytes += key.size();
+        code_points += basic_string_view<unicode::utf8> {key.data(), key.data() + key.size()}.length();
+    }
+
+    auto table = std::vector<string_type> {};
+    for (auto& key : keys) table.emplace_back(key.data(), key.data() + key.size());
+
+    set_workload(bytes, code_points);
+
+    BENCHMARK("table construction " + name) {
+        auto result = std::vector<string_type> {};
+        result.reserve(keys.size());
+        for (auto& key : keys) result.emplace_back(key.data(), key.data() + key.size());
+        return result;
+    };
+
+    BENCHMARK("table scan " + name) {
+        auto sum = uint32_t {0};
+        for (auto& str : table) for (auto cp : str) sum += cp;
+        return sum;
+    };
+
+    BENCHMARK("table copy " + name) {
+        return table;
+    };
+}
+
+TEST_CASE("String inline capacity", "[string]") {
+    auto keys = std::vector<std::vector<unicode::utf8::code_unit>> {};
+    auto random = corpus_random {0};
+
+    for (size_t i = 0; i < 10000; i++) {
+        auto length = random.between(8, 60);
+        keys.push_back(corpus_string<unicode::utf8>(language_profile::ascii_english, length, i));
+    }
+
+    inline_capacity_benchmarks<compact_inline_bytes>(keys);
+    inline_capacity_benchmarks<32>(keys);
+    inline_capacity_benchmarks<64>(keys);
+    inline_capacity_benchmarks<128>(keys);
+}
+
+// The same keys as a vector of strings and as a column, which validates
+// them all at once and keeps their code units contiguous.
+TEST_CASE("String column", "[string]") {
+    auto units = std::vector<unicode::utf8::code_unit> {};
+    auto sizes = std::vector<size_t> {};
+    auto code_points = size_t {0};
+    auto random = corpus_random {0};
+
+    for (size_t i = 0; i < 100000; i++) {
+        auto length = random.between(8, 60);
+        auto key = corpus_string<unicode::utf8>(language_profiles[i % language_profiles.size()], length, i);
+
+        units.insert(units.end(), key.begin(), key.end());
+        sizes.push_back(key.size());
+        code_points += length;
+    }
+
+    auto column = string_column<unicode::utf8> {};
+    column.append_batch(units, sizes);
+
+    auto strings = std::vector<string> {column.begin(), column.end()};
+
+    set_workload(units.size(), code_points);
+
+    BENCHMARK("vector construction") {
+        auto result = std::vector<string> {};
+        auto it = units.data();
+
+        for (auto size : sizes) {
+            result.emplace_back(it, it + size);
+            it += size;
+        }
+
+        return result;
+    };
+
+    BENCHMARK("column construction") {
+        auto result = string_column<unicode::utf8> {};
+        result.append_batch(units, sizes);
+        return result;
+    };
+
+    BENCHMARK("vector scan") {
+        auto sum = uint32_t {0};
+        for (auto& str : strings) for (auto cp : str) sum += cp;
+        return sum;
+    };
+
+    BENCHMARK("column scan") {
+        auto sum = uint32_t {0};
+        for (auto str : column) for (auto cp : str) sum += cp;
+        return sum;
+    };
+
+    BENCHMARK("vector transcoding") {
+        auto result = std::vector<utf16le_string> {};
+        result.reserve(strings.size());
+        for (auto& str : strings) result.emplace_back(str);
+        return result;
+    };
+
+    BENCHMARK("column transcoding one thread") {
+        return column.transcode<unicode::utf16le>(1);
+    };
+
+    BENCHMARK("column transcoding") {
+        return column.transcode<unicode::utf16le>();
+    };
+}
+
+TEST_CASE("String table", "[string]") {
+    auto strings = std::vector<string> {};
+    auto code_points = size_t {0};
+    auto units = size_t {0};
+    auto key_code_points = size_t {0};
+    auto key_units = size_t {0};
+    auto scanned_code_points = size_t {0};
+    auto scanned_units = size_t {0};
+    auto random = corpus_random {0};
+
+    // Every thousandth string is looked up.
+    constexpr auto key_step = size_t {1000};
+
+    for (size_t i = 0; i < 100000; i++) {
+        auto length = random.between(8, 60);
+        auto key = corpus_string<unicode::utf8>(language_profiles[i % language_profiles.size()], length, i);
+
+        strings.emplace_back(key.data(), key.data() + key.size());
+        code_points += length;
+        units += key.size();
+
+        if (i % key_step == 0) {
+            key_code_points += length;
+            key_units += key.size();
+            scanned_code_points += code_points;
+            scanned_units += units;
+        }
+    }
+
+    auto bytes = write_string_table<unicode::utf8>(strings);
+    auto table = string_table<unicode::utf8> {bytes};
+
+    set_workload(units, code_points);
+
+    BENCHMARK("vector construction") {
+        return std::vector<string> {table.begin(), table.end()};
+    };
+
+    // Opening a table reads its header and the first and last offsets, the
+    // checksum reads all of it and the full check decodes its strings too.
+    set_workload(sizeof(unicode::detail::string_table_header) + 2 * sizeof(uint64_t), 0);
+
+    BENCHMARK("table open") {
+        return string_table<unicode::utf8> {bytes, string_table_check::header}.size();
+    };
+
+    set_workload(bytes.size(), 0);
+
+    BENCHMARK("table open with checksum") {
+        return string_table<unicode::utf8> {bytes, string_table_check::checksum}.size();
+    };
+
+    set_workload(bytes.size(), code_points);
+
+    BENCHMARK("table open with full check") {
+        return string_table<unicode::utf8> {bytes, string_table_check::full}.size();
+    };
+
+    // A linear search compares the key with every string up to it, the hash
+    // index only with the key.
+    set_workload(scanned_units, scanned_code_points);
+
+    BENCHMARK("vector find") {
+        auto found = size_t {0};
+        for (size_t i = 0; i < strings.size(); i += key_step) found += std::ranges::find(strings, strings[i]) - strings.begin();
+        return found;
+    };
+
+    set_workload(key_units, key_code_points);
+
+    BENCHMARK("table find") {
+        auto found = size_t {0};
+        for (size_t i = 0; i < strings.size(); i += key_step) found += *table.find(strings[i]);
+        return found;
+    };
+}
+
+TEST_CASE("Any string view", "[string]") {
+    auto data = std::vector<std::vector<uint32_t>> {};
+    auto views = std::vector<any_string_view> {};
+    auto units = size_t {0};
+    auto code_points = size_t {0};
+
+    // Buffers of every encoding, as an ingestion layer receives them.
+    for (size_t i = 0; i < 10000; i++) {
+        auto id = unicode::encoding_ids[i % unicode::encoding_ids.size()];
+        auto key = corpus_string<unicode::utf8>(language_profiles[i % language_profiles.size()], 40, i);
+        auto str = utf8_string {key.data(), key.data() + key.size()};
+        auto transcoded = any_string {str, id};
+        auto bytes = transcoded.bytes();
+
+        data.emplace_back((bytes.size() + 3) / 4);
+        std::memcpy(data.back().data(), bytes.data(), bytes.size());
+        views.emplace_back(std::as_bytes(std::span {data.back()}).first(bytes.size()), id);
+
+        units += str.code_units().size();
+        code_points += 40;
+    }
+
+    set_workload(units, code_points);
+
+    BENCHMARK("transcoding to UTF-8 and hashing") {
+        auto sum = size_t {0};
+        for (auto sv : views) sum += std::hash<utf8_string> {}(sv.transcode<unicode::utf8>());
+        return sum;
+    };
+
+    BENCHMARK("hashing in place") {
+        auto sum = size_t {0};
+        for (auto sv : views) sum += std::hash<any_string_view> {}(sv);
+        return sum;
+    };
+
+    BENCHMARK("transcoding to UTF-8 and counting") {
+        auto sum = size_t {0};
+        for (auto sv : views) sum += sv.transcode<unicode::utf8>().length();
+        return sum;
+    };
+
+    BENCHMARK("counting in place") {
+        auto sum = size_t {0};
+        for (auto sv : views) sum += sv.length();
+        return sum;
+    };
+}
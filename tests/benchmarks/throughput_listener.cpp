@@ -0,0 +1,58 @@
+#include "detail/throughput.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/interfaces/catch_interfaces_reporter.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Prints the throughput of every benchmark from the workload it declared to
+// stderr, leaving stdout to the reporter.
+// When CPPUNICODE_BENCHMARK_CSV names a file, a row is also appended to it
+// for each benchmark, so that runs of different versions can be compared.
+struct throughput_listener : Catch::EventListenerBase {
+
+    using Catch::EventListenerBase::EventListenerBase;
+
+    auto testCaseStarting(const Catch::TestCaseInfo& info) -> void override {
+        m_test_case = info.name;
+    }
+
+    auto benchmarkEnded(const Catch::BenchmarkStats<>& stats) -> void override {
+        auto ns = stats.mean.point.count();
+        auto load = current_workload;
+        auto gb_per_s = static_cast<double>(load.bytes) / ns;
+        auto mcp_per_s = static_cast<double>(load.code_points) / ns * 1000;
+
+        std::fprintf(
+            stderr, "%s: %.3f GB/s, %.1f M code points/s\n",
+            stats.info.name.c_str(), gb_per_s, mcp_per_s
+        );
+
+        if (auto path = std::getenv("CPPUNICODE_BENCHMARK_CSV")) {
+            if (auto file = std::fopen(path, "a")) {
+                std::fseek(file, 0, SEEK_END);
+
+                if (std::ftell(file) == 0) {
+                    std::fputs("test_case,benchmark,bytes,code_points,mean_ns,gb_per_s,mcp_per_s\n", file);
+                }
+
+                std::fprintf(
+                    file, "\"%s\",\"%s\",%zu,%zu,%.3f,%.6f,%.3f\n",
+                    m_test_case.c_str(), stats.info.name.c_str(),
+                    load.bytes, load.code_points, ns, gb_per_s, mcp_per_s
+                );
+
+                std::fclose(file);
+            }
+        }
+    }
+
+  private:
+    std::string m_test_case;
+};
+
+CATCH_REGISTER_LISTENER(throughput_listener)
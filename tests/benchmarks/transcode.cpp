@@ -0,0 +1,85 @@
+#include "../src/detail/corpus_generator.hpp"
+#include "detail/throughput.hpp"
+
+#include <bigj/any_string.hpp>
+#include <bigj/encoding_detection.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+#include <bigj/transcode.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+using namespace bigj;
+
+static constexpr auto length = size_t {1 << 16};
+
+template<unicode::encoding E, unicode::encoding F>
+static auto conversion_benchmarks(const std::string& to, const std::string& from) -> void {
+    for (auto profile : language_profiles) {
+        auto name = from + " to " + to + " " + to_string(profile);
+        auto data = corpus_string<F>(profile, length);
+        auto str = basic_string<F> {data.data(), data.data() + data.size()};
+        auto sv = basic_string_view<F> {str};
+        auto buffer = std::vector<typename E::code_unit>(basic_string<E> {sv}.size());
+
+        set_workload(str.size() * sizeof(typename F::code_unit), length);
+
+        BENCHMARK("conversion " + name) {
+            return basic_string<E> {sv};
+        };
+
+        BENCHMARK("transcode view " + name) {
+            return views::transcode<E>(sv).copy_to(buffer).size();
+        };
+    }
+}
+
+template<unicode::encoding F>
+static auto conversion_benchmarks(const std::string& from) -> void {
+    conversion_benchmarks<unicode::utf8, F>("utf8", from);
+    conversion_benchmarks<unicode::utf16le, F>("utf16le", from);
+    conversion_benchmarks<unicode::utf16be, F>("utf16be", from);
+    conversion_benchmarks<unicode::utf32le, F>("utf32le", from);
+    conversion_benchmarks<unicode::utf32be, F>("utf32be", from);
+}
+
+TEST_CASE("Conversion throughput", "[transcode]") {
+    conversion_benchmarks<unicode::utf8>("utf8");
+    conversion_benchmarks<unicode::utf16le>("utf16le");
+    conversion_benchmarks<unicode::utf16be>("utf16be");
+    conversion_benchmarks<unicode::utf32le>("utf32le");
+    conversion_benchmarks<unicode::utf32be>("utf32be");
+}
+
+TEST_CASE("Encoding detection throughput", "[transcode]") {
+    for (auto profile : language_profiles) {
+        auto data = corpus_string<unicode::utf8>(profile, length);
+        auto str = string {data.data(), data.data() + data.size()};
+
+        for (auto id : unicode::encoding_ids) {
+            auto name = std::string {unicode::to_string(id)} + " " + to_string(profile);
+            auto encoded = any_string {str, id};
+            auto buffer = std::vector<uint64_t>((encoded.bytes().size() + 7) / 8);
+            std::memcpy(buffer.data(), encoded.bytes().data(), encoded.bytes().size());
+
+            auto bytes = std::as_bytes(std::span {buffer}).first(encoded.bytes().size());
+
+            set_workload(bytes.size(), length);
+
+            BENCHMARK("detection " + name) {
+                return detect_encoding(bytes).confidence;
+            };
+
+            BENCHMARK("detection and validation " + name) {
+                return detect_string(bytes).string.bytes().size();
+            };
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#include "detail/corpus_generator.hpp"
+
+#include <bigj/any_string.hpp>
+#include <bigj/any_string_view.hpp>
+#include <bigj/literals.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+using namespace bigj;
+using namespace bigj::literals;
+using unicode::encoding_id;
+
+TEMPLATE_TEST_CASE(
+    "Any string view",
+    "[any_string]",
+    unicode::utf8,
+    unicode::utf16le,
+    unicode::utf16be,
+    unicode::utf32le,
+    unicode::utf32be
+) {
+    using E = TestType;
+
+    auto profile = GENERATE(from_range(language_profiles));
+    auto data = corpus_string<E>(profile, 200);
+    auto typed = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto sv = any_string_view {typed};
+
+    SECTION("encoding") {
+        REQUIRE(sv.encoding() == unicode::encoding_id_of<E>);
+        REQUIRE(sv.template holds<E>());
+        REQUIRE(sv.template get<E>().code_units().data() == data.data());
+        REQUIRE(sv.bytes().data() == reinterpret_cast<const std::byte*>(data.data()));
+        REQUIRE(sv.bytes().size() == sizeof(typename E::code_unit) * data.size());
+        REQUIRE(sv.length() == typed.length());
+        REQUIRE_FALSE(sv.empty());
+
+        if constexpr (!std::same_as<E, unicode::utf8>) {
+            REQUIRE_FALSE(sv.template holds<unicode::utf8>());
+            REQUIRE_THROWS_AS(sv.template get<unicode::utf8>(), std::bad_variant_access);
+        }
+    }
+
+    SECTION("bytes") {
+        REQUIRE(any_string_view {sv.bytes(), sv.encoding()}.bytes().data() == sv.bytes().data());
+        REQUIRE_THROWS_AS((any_string_view {sv.bytes(), encoding_id {0}}), std::invalid_argument);
+
+        if constexpr (sizeof(typename E::code_unit) > 1) {
+            REQUIRE_THROWS_AS((any_string_view {sv.bytes().subspan(1), sv.encoding()}), std::invalid_argument);
+            REQUIRE_THROWS_AS((any_string_view {sv.bytes().first(sv.bytes().size() - 1), sv.encoding()}), std::invalid_argument);
+        }
+    }
+
+    SECTION("comparison and hash across encodings") {
+        auto id = GENERATE(from_range(unicode::encoding_ids));
+        auto other = any_string {sv, id};
+        auto view = any_string_view {other};
+
+        REQUIRE(other.encoding() == id);
+        REQUIRE(view == sv);
+        REQUIRE(view == typed);
+        REQUIRE((view <=> sv) == std::strong_ordering::equal);
+        REQUIRE(std::hash<any_string_view> {}(view) == std::hash<basic_string_view<E>> {}(typed));
+
+        auto shorter = any_string {sv.template get<E>().substring(typed.begin(), std::prev(typed.end())), id};
+        REQUIRE(shorter != sv);
+        REQUIRE(shorter < sv);
+    }
+
+    SECTION("search across encodings") {
+        auto id = GENERATE(from_range(unicode::encoding_ids));
+
+        auto middle = std::next(typed.begin(), 100);
+        auto suffix = basic_string_view<E> {middle, typed.end()};
+        auto position = static_cast<size_t>(middle.address() - data.data());
+
+        REQUIRE(sv.find(any_string {suffix, id}) <= position);
+        REQUIRE(sv.find(any_string {suffix, id}) == static_cast<size_t>(typed.find(suffix).address() - data.data()));
+        REQUIRE(sv.contains(any_string {suffix, id}));
+        REQUIRE(sv.ends_with(any_string {suffix, id}));
+        REQUIRE(sv.starts_with(any_string {basic_string_view<E> {typed.begin(), middle}, id}));
+        REQUIRE(sv.find(any_string {}) == 0);
+        REQUIRE_FALSE(sv.find(u8"\U0010FFFF"_s).has_value());
+    }
+}
+
+TEST_CASE("Any string", "[any_string]") {
+    auto data = corpus_string<unicode::utf16le>(language_profiles[0], 500);
+    auto typed = utf16le_string {data.data(), data.data() + data.size()};
+    auto str = any_string {typed};
+
+    SECTION("adopts strings without copying") {
+        REQUIRE(str.encoding() == encoding_id::utf16le);
+        REQUIRE(str.get<unicode::utf16le>().code_units().data() == typed.code_units().data());
+        REQUIRE(str.transcode<unicode::utf16le>().code_units().data() == typed.code_units().data());
+        REQUIRE(str.transcode(encoding_id::utf16le).bytes().data() == str.bytes().data());
+        REQUIRE(any_string {compact_utf16le_string {typed}}.bytes().data() == str.bytes().data());
+    }
+
+    SECTION("transcodes on request") {
+        auto utf8 = str.transcode(encoding_id::utf8);
+
+        REQUIRE(utf8.encoding() == encoding_id::utf8);
+        REQUIRE(utf8 == str);
+        REQUIRE(utf8 == typed);
+        REQUIRE(utf8.length() == typed.length());
+        REQUIRE(utf8.get<unicode::utf8>() == str.transcode<unicode::utf8>());
+    }
+
+    SECTION("copies views") {
+        auto copy = any_string {any_string_view {typed}};
+
+        REQUIRE(copy.encoding() == encoding_id::utf16le);
+        REQUIRE(copy == typed);
+    }
+
+    SECTION("validates bytes") {
+        auto bytes = std::as_bytes(std::span {data});
+        REQUIRE(any_string {bytes, encoding_id::utf16le} == str);
+        REQUIRE_THROWS_AS((any_string {bytes, encoding_id::utf32be}), unicode::parse_error);
+    }
+
+    SECTION("hash") {
+        auto strings = std::unordered_set<any_string> {};
+
+        for (auto id : unicode::encoding_ids) {
+            strings.insert(str.transcode(id));
+            strings.insert(u8"other"_s);
+        }
+
+        REQUIRE(strings.size() == 2);
+        REQUIRE(std::hash<any_string> {}(str) == std::hash<utf16le_string> {}(typed));
+    }
+
+    SECTION("default") {
+        auto empty = any_string {};
+
+        REQUIRE(empty.empty());
+        REQUIRE(empty.encoding() == encoding_id::utf8);
+        REQUIRE(empty == utf32be_string {});
+        REQUIRE(str.starts_with(empty));
+    }
+}
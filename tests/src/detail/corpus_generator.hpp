@@ -0,0 +1,256 @@
+#pragma once
+
+#include <bigj/unicode/detail/decode.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// Kinds of text with the mix of code unit widths found in real documents,
+// unlike code points drawn uniformly from the whole code space, which are
+// almost all outside the BMP.
+enum class language_profile {
+    ascii_english,
+    latin1_european,
+    cyrillic,
+    cjk,
+    emoji,
+    mixed_markup,
+};
+
+inline constexpr auto language_profiles = std::array {
+    language_profile::ascii_english,
+    language_profile::latin1_european,
+    language_profile::cyrillic,
+    language_profile::cjk,
+    language_profile::emoji,
+    language_profile::mixed_markup,
+};
+
+inline auto to_string(language_profile profile) -> std::string {
+    switch (profile) {
+        case language_profile::ascii_english: return "ascii_english";
+        case language_profile::latin1_european: return "latin1_european";
+        case language_profile::cyrillic: return "cyrillic";
+        case language_profile::cjk: return "cjk";
+        case language_profile::emoji: return "emoji";
+        default: return "mixed_markup";
+    }
+}
+
+// A SplitMix64 generator, which unlike the standard distributions produces
+// the same sequence with every standard library.
+struct corpus_random {
+
+    explicit corpus_random(uint64_t seed) noexcept : m_state {seed} {}
+
+    auto next() noexcept -> uint64_t {
+        auto z = (m_state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    // Returns a number between first and last, both included.
+    auto between(uint32_t first, uint32_t last) noexcept -> uint32_t {
+        return first + static_cast<uint32_t>(next() % (uint64_t {last} - first + 1));
+    }
+
+    // Returns true with a probability of numerator / denominator.
+    auto chance(uint32_t numerator, uint32_t denominator) noexcept -> bool {
+        return next() % denominator < numerator;
+    }
+
+  private:
+    uint64_t m_state;
+};
+
+namespace corpus_detail {
+
+inline auto ascii_letter(corpus_random& random) -> uint32_t {
+    // Weighted towards the most frequent letters of English.
+    constexpr auto frequent = std::string_view {"etaoinshrdlcumwfgypbvkjxqz"};
+    auto index = std::min(random.between(0, 25), random.between(0, 25));
+    return static_cast<uint32_t>(frequent[index]);
+}
+
+inline auto latin1_letter(corpus_random& random) -> uint32_t {
+    if (random.chance(1, 6)) {
+        auto cp = random.between(0xC0, 0xFF);
+        return cp == 0xD7 || cp == 0xF7 ? cp + 1 : cp;
+    } else {
+        return ascii_letter(random);
+    }
+}
+
+inline auto emoji(corpus_random& random, std::vector<uint32_t>& out) -> void {
+    switch (random.between(0, 3)) {
+        case 0:
+            out.push_back(random.between(0x1F300, 0x1F5FF));
+            break;
+        case 1:
+            // An emoji with a skin tone modifier.
+            out.push_back(random.between(0x1F466, 0x1F469));
+            out.push_back(random.between(0x1F3FB, 0x1F3FF));
+            break;
+        case 2:
+            // A BMP symbol with an emoji presentation selector.
+            out.push_back(random.between(0x2600, 0x26FF));
+            out.push_back(0xFE0F);
+            break;
+        default:
+            out.push_back(random.between(0x1F600, 0x1F64F));
+            break;
+    }
+}
+
+// Appends one word of a profile, followed by the punctuation or space that
+// separates it from the next one.
+inline auto word(language_profile profile, corpus_random& random, std::vector<uint32_t>& out) -> void {
+    auto length = random.between(1, 9);
+
+    switch (profile) {
+        case language_profile::cjk:
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(random.chance(1, 5) ? random.between(0x3041, 0x30FF) : random.between(0x4E00, 0x9FFF));
+            }
+
+            out.push_back(random.chance(1, 4) ? 0x3002 : 0x3001);
+            return;
+        case language_profile::cyrillic:
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(random.between(i == 0 && random.chance(1, 8) ? 0x0410 : 0x0430, 0x044F));
+            }
+
+            break;
+        case language_profile::latin1_european:
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(latin1_letter(random));
+            }
+
+            break;
+        case language_profile::emoji:
+            if (random.chance(1, 3)) {
+                emoji(random, out);
+                break;
+            }
+
+            [[fallthrough]];
+        default:
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(ascii_letter(random));
+            }
+
+            break;
+    }
+
+    if (random.chance(1, 12)) {
+        out.push_back(random.chance(1, 2) ? U'.' : U',');
+    }
+
+    out.push_back(random.chance(1, 16) ? U'\n' : U' ');
+}
+
+inline auto markup(corpus_random& random, std::vector<uint32_t>& out) -> void {
+    constexpr auto tags = std::array<std::u32string_view, 4> {U"p", U"div", U"span", U"a"};
+    auto tag = tags[random.between(0, tags.size() - 1)];
+
+    out.push_back(U'<');
+    out.insert(out.end(), tag.begin(), tag.end());
+
+    for (auto c : std::u32string_view {U" class=\"text\">"}) {
+        out.push_back(c);
+    }
+
+    auto profile = language_profiles[random.between(0, language_profiles.size() - 2)];
+
+    for (auto i = random.between(1, 8); i != 0; i--) {
+        word(profile, random, out);
+    }
+
+    out.push_back(U'<');
+    out.push_back(U'/');
+    out.insert(out.end(), tag.begin(), tag.end());
+    out.push_back(U'>');
+    out.push_back(U'\n');
+}
+
+} // namespace corpus_detail
+
+// Generates length code points of text of a profile. The same arguments
+// always give the same text.
+inline auto corpus_code_points(language_profile profile, size_t length, uint64_t seed = 0)
+    -> std::vector<uint32_t>
+{
+    auto random = corpus_random {seed};
+    auto result = std::vector<uint32_t> {};
+
+    while (result.size() < length) {
+        if (profile == language_profile::mixed_markup) {
+            corpus_detail::markup(random, result);
+        } else {
+            corpus_detail::word(profile, random, result);
+        }
+    }
+
+    result.resize(length);
+    return result;
+}
+
+template<bigj::unicode::encoding E>
+auto corpus_string(language_profile profile, size_t length, uint64_t seed = 0)
+    -> std::vector<typename E::code_unit>
+{
+    auto code_points = corpus_code_points(profile, length, seed);
+    auto size = size_t {0};
+    for (auto cp : code_points) size += E::encoded_size(cp);
+
+    auto str = std::vector<typename E::code_unit>(size);
+    auto data = str.data();
+    for (auto cp : code_points) data = E::encode(cp, data);
+
+    return str;
+}
+
+// Corrupts about one in every rate code units of str and returns how many
+// were corrupted, str failing validation whenever any were. UTF-8 gets bytes
+// that never appear in it, UTF-16 lone surrogates and UTF-32 values above
+// the code space.
+template<bigj::unicode::encoding E>
+auto inject_invalid_units(std::vector<typename E::code_unit>& str, uint32_t rate, uint64_t seed = 0)
+    -> size_t
+{
+    using code_unit = typename E::code_unit;
+    using bigj::unicode::detail::load_unit;
+    using bigj::unicode::detail::utf_traits;
+
+    constexpr auto bits = utf_traits<E>::bits;
+    static_assert(bits != 0);
+
+    auto random = corpus_random {seed};
+    auto count = size_t {0};
+
+    for (size_t i = 0; i < str.size(); i++) {
+        if (!random.chance(1, rate)) continue;
+
+        if constexpr (bits == 8) {
+            str[i] = static_cast<code_unit>(random.chance(1, 2) ? 0xFF : 0xC0);
+        } else if constexpr (bits == 16) {
+            // A low surrogate is only valid after a high one, which is in
+            // turn made invalid by another high surrogate following it.
+            auto after_high = i != 0 && (load_unit<E>(&str[i - 1]) & 0xFC00) == 0xD800;
+            E::encode(after_high ? 0xD800 : 0xDC00, &str[i]);
+        } else {
+            E::encode(random.between(0x110000, 0xFFFFFF), &str[i]);
+        }
+
+        count++;
+    }
+
+    return count;
+}
@@ -43,6 +43,10 @@ TEMPLATE_TEST_CASE("UTF-16 encoding / decoding / iteration", "[utf][utf16]", utf
         REQUIRE(TestType::next_code_point(data.data()) == data.data() + size);
         REQUIRE(TestType::prev_code_point(data.data() + size) == data.data());
 
+        auto it = static_cast<const code_unit*>(data.data());
+        REQUIRE(TestType::decode_and_advance(it) == cp);
+        REQUIRE(it == data.data() + size);
+
         for (size_t i = 0; i < size; i++) {
             if constexpr (std::same_as<TestType, utf16<std::endian::native>>) {
                 REQUIRE((data[i] & mask[i]) == test[i]);
@@ -32,6 +32,10 @@ TEMPLATE_TEST_CASE("UTF-32 encoding / decoding / iteration", "[utf][utf32]", utf
         REQUIRE(TestType::next_code_point(&data) == &data + 1);
         REQUIRE(TestType::prev_code_point(&data + 1) == &data);
 
+        auto it = static_cast<const code_unit*>(&data);
+        REQUIRE(TestType::decode_and_advance(it) == cp);
+        REQUIRE(it == &data + 1);
+
         if constexpr (std::same_as<TestType, utf32<std::endian::native>>) {
             REQUIRE(data == cp);
         } else {
@@ -47,6 +47,10 @@ TEST_CASE("UTF-8 encoding / decoding / iteration", "[utf][utf8]") {
         REQUIRE(utf8::next_code_point(data.data()) == data.data() + size);
         REQUIRE(utf8::prev_code_point(data.data() + size) == data.data());
 
+        auto it = static_cast<const code_unit*>(data.data());
+        REQUIRE(utf8::decode_and_advance(it) == cp);
+        REQUIRE(it == data.data() + size);
+
         for (size_t i = 0; i < size; i++) {
             REQUIRE((data[i] & mask[i]) == test[i]);
         }
@@ -0,0 +1,123 @@
+#include "detail/corpus_generator.hpp"
+
+#include <bigj/any_string.hpp>
+#include <bigj/encoding_detection.hpp>
+#include <bigj/literals.hpp>
+#include <bigj/string.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <cstring>
+
+using namespace bigj;
+using namespace bigj::literals;
+using unicode::encoding_id;
+
+// Bytes of str in the encoding id, after a byte order mark if one is given,
+// in a buffer aligned to any code unit.
+static auto encoded_bytes(const string& str, encoding_id id, std::vector<uint8_t> bom = {})
+    -> std::vector<uint64_t>
+{
+    auto transcoded = any_string {str, id};
+    auto bytes = transcoded.bytes();
+
+    auto buffer = std::vector<uint64_t>((bom.size() + bytes.size() + 7) / 8);
+    auto data = reinterpret_cast<std::byte*>(buffer.data());
+    std::copy(bom.begin(), bom.end(), reinterpret_cast<uint8_t*>(data));
+    std::memcpy(data + bom.size(), bytes.data(), bytes.size());
+
+    return buffer;
+}
+
+static auto first_bytes(const std::vector<uint64_t>& buffer, size_t size) -> std::span<const std::byte> {
+    return std::as_bytes(std::span {buffer}).first(size);
+}
+
+TEST_CASE("Encoding detection from statistics", "[encoding_detection]") {
+    auto profile = GENERATE(from_range(language_profiles));
+    auto id = GENERATE(from_range(unicode::encoding_ids));
+    auto length = GENERATE(size_t {20}, size_t {3000});
+
+    auto data = corpus_string<unicode::utf8>(profile, length);
+    auto str = string {data.data(), data.data() + data.size()};
+    auto buffer = encoded_bytes(str, id);
+    auto bytes = first_bytes(buffer, any_string {str, id}.bytes().size());
+
+    auto detection = detect_encoding(bytes);
+
+    INFO(to_string(profile) << " in " << to_string(id));
+    REQUIRE(detection.encoding == id);
+    REQUIRE(detection.bom_size == 0);
+    REQUIRE(detection.confidence > 0.5);
+    REQUIRE(detection.confidence <= 1);
+
+    auto detected = detect_string(bytes);
+    REQUIRE(detected.string.encoding() == id);
+    REQUIRE(detected.string == str);
+}
+
+TEST_CASE("Encoding detection from byte order marks", "[encoding_detection]") {
+    auto [id, bom] = GENERATE(table<encoding_id, std::vector<uint8_t>>({
+        {encoding_id::utf8, {0xEF, 0xBB, 0xBF}},
+        {encoding_id::utf16le, {0xFF, 0xFE}},
+        {encoding_id::utf16be, {0xFE, 0xFF}},
+        {encoding_id::utf32le, {0xFF, 0xFE, 0x00, 0x00}},
+        {encoding_id::utf32be, {0x00, 0x00, 0xFE, 0xFF}},
+    }));
+
+    auto str = string {u8"Ünïcödé text 🙂"_s};
+    auto buffer = encoded_bytes(str, id, bom);
+    auto bytes = first_bytes(buffer, bom.size() + any_string {str, id}.bytes().size());
+
+    auto detection = detect_encoding(bytes);
+    REQUIRE(detection.encoding == id);
+    REQUIRE(detection.confidence == 1);
+    REQUIRE(detection.bom_size == bom.size());
+
+    auto stripped = detect_string(bytes);
+    REQUIRE(stripped.string == str);
+    REQUIRE(stripped.string.bytes().data() == bytes.data() + bom.size());
+
+    auto kept = detect_string(bytes, false);
+    REQUIRE(kept.string.length() == str.length() + 1);
+    REQUIRE(kept.string.ends_with(str));
+    REQUIRE(kept.string.starts_with(u8"\uFEFF"_s));
+}
+
+TEST_CASE("Encoding detection of unusual input", "[encoding_detection]") {
+    SECTION("empty") {
+        auto detection = detect_encoding({});
+
+        REQUIRE(detection.encoding == encoding_id::utf8);
+        REQUIRE(detection.confidence == 0);
+        REQUIRE(detect_string({}).string.empty());
+    }
+
+    SECTION("sizes that rule out wider code units") {
+        auto buffer = encoded_bytes(u8"abc"_s, encoding_id::utf8);
+        REQUIRE(detect_encoding(first_bytes(buffer, 3)).encoding == encoding_id::utf8);
+    }
+
+    SECTION("invalid in every encoding") {
+        auto bytes = std::vector<std::byte>(4097, std::byte {0xFF});
+        auto detection = detect_encoding(bytes);
+
+        REQUIRE(detection.confidence == 0);
+        REQUIRE_THROWS_AS(detect_string(bytes), unicode::parse_error);
+    }
+
+    SECTION("misaligned") {
+        auto buffer = encoded_bytes(u8"misaligned text"_s, encoding_id::utf16le, {0});
+        auto bytes = first_bytes(buffer, 31).subspan(1);
+
+        REQUIRE(detect_encoding(bytes).encoding == encoding_id::utf16le);
+        REQUIRE_THROWS_AS(detect_string(bytes), std::invalid_argument);
+    }
+}
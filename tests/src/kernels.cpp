@@ -0,0 +1,153 @@
+#include "detail/corpus_generator.hpp"
+
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+#include <bigj/transcode.hpp>
+#include <bigj/unicode/detail/count.hpp>
+#include <bigj/unicode/detail/hash.hpp>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+using namespace bigj;
+
+// The code points of a string decoded one at a time by its iterator.
+template<unicode::encoding E>
+static auto reference_code_points(basic_string_view<E> sv) -> std::vector<uint32_t> {
+    auto result = std::vector<uint32_t> {};
+    for (auto cp : sv) result.push_back(cp);
+    return result;
+}
+
+template<unicode::encoding E>
+static auto reference_units(const std::vector<uint32_t>& code_points) -> std::vector<typename E::code_unit> {
+    auto result = std::vector<typename E::code_unit> {};
+
+    for (auto cp : code_points) {
+        auto units = std::array<typename E::code_unit, 4> {};
+        auto end = E::encode(cp, units.data());
+        result.insert(result.end(), units.data(), end);
+    }
+
+    return result;
+}
+
+template<unicode::encoding E, unicode::encoding F>
+static auto check_transcoding(basic_string_view<F> sv, const std::vector<uint32_t>& code_points) -> void {
+    auto expected = reference_units<E>(code_points);
+    auto str = basic_string<E> {sv};
+
+    REQUIRE(std::ranges::equal(str.code_units(), expected));
+
+    auto buffer = std::vector<typename E::code_unit>(expected.size());
+    auto written = views::transcode<E>(sv).copy_to(buffer);
+    REQUIRE(std::ranges::equal(written, expected));
+}
+
+TEMPLATE_TEST_CASE(
+    "Fast paths agree with the scalar reference",
+    "[kernels]",
+    unicode::utf8,
+    unicode::utf16le,
+    unicode::utf16be,
+    unicode::utf32le,
+    unicode::utf32be
+) {
+    using E = TestType;
+
+    auto profile = GENERATE(from_range(language_profiles));
+    auto length = GENERATE(0, 1, 7, 64, 1000);
+    auto seed = GENERATE(range<uint64_t>(0, 4));
+
+    auto data = corpus_string<E>(profile, length, seed);
+    auto sv = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto code_points = reference_code_points(sv);
+    auto begin = data.data();
+    auto end = data.data() + data.size();
+
+    REQUIRE(code_points == corpus_code_points(profile, length, seed));
+
+    SECTION("counting") {
+        auto utf16_units = size_t {0};
+        for (auto cp : code_points) utf16_units += cp > 0xFFFF ? 2 : 1;
+
+        REQUIRE(unicode::detail::count_code_points<E>(begin, end) == code_points.size());
+        REQUIRE(unicode::detail::count_utf16_units<E>(begin, end) == utf16_units);
+
+        for (auto n : {size_t {0}, code_points.size() / 3, code_points.size()}) {
+            auto left = n;
+            auto it = unicode::detail::advance_code_points<E>(begin, end, left);
+
+            REQUIRE(left == 0);
+            REQUIRE(it == std::next(sv.begin(), static_cast<ptrdiff_t>(n)).address());
+        }
+    }
+
+    SECTION("decoding") {
+        auto decoded = std::vector<uint32_t> {};
+        auto buffer = std::array<unicode::code_point, 7> {};
+
+        for (auto block : sv.decode_blocks(buffer)) {
+            decoded.insert(decoded.end(), block.begin(), block.end());
+        }
+
+        REQUIRE(decoded == code_points);
+    }
+
+    SECTION("transcoding") {
+        check_transcoding<unicode::utf8>(sv, code_points);
+        check_transcoding<unicode::utf16le>(sv, code_points);
+        check_transcoding<unicode::utf16be>(sv, code_points);
+        check_transcoding<unicode::utf32le>(sv, code_points);
+        check_transcoding<unicode::utf32be>(sv, code_points);
+    }
+
+    SECTION("hashing") {
+        auto utf32 = reference_units<unicode::utf32le>(code_points);
+        auto expected = unicode::detail::hash_bytes(utf32.data(), sizeof(uint32_t) * utf32.size());
+
+        REQUIRE(unicode::detail::hash_code_points<E>(begin, end) == expected);
+    }
+
+    SECTION("comparison") {
+        auto other = corpus_string<E>(profile, length, seed + 1);
+        auto other_sv = basic_string_view<E> {other.data(), other.data() + other.size()};
+        auto other_code_points = reference_code_points(other_sv);
+
+        REQUIRE((sv <=> other_sv) == (code_points <=> other_code_points));
+        REQUIRE((sv == other_sv) == (code_points == other_code_points));
+    }
+
+    SECTION("search") {
+        if (code_points.size() >= 8) {
+            auto first = std::next(sv.begin(), static_cast<ptrdiff_t>(code_points.size() / 2));
+            auto needle = sv.substring(first, std::next(first, 4));
+            auto expected = std::ranges::search(sv.code_points(), needle.code_points());
+
+            REQUIRE(sv.find(needle) == expected.begin());
+            REQUIRE(sv.count(U' ') == static_cast<size_t>(std::ranges::count(code_points, U' ')));
+        }
+    }
+
+    SECTION("validation") {
+        auto rate = GENERATE(50u, 1000u);
+        auto corrupted = data;
+        auto count = inject_invalid_units<E>(corrupted, rate, seed);
+        auto construct = [&] { return basic_string<E> {corrupted.data(), corrupted.data() + corrupted.size()}; };
+
+        if (count == 0) {
+            REQUIRE_NOTHROW(construct());
+        } else {
+            REQUIRE_THROWS_AS(construct(), unicode::parse_error);
+        }
+    }
+}
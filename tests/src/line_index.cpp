@@ -0,0 +1,129 @@
+#include "detail/random_string_generator.hpp"
+
+#include <bigj/line_index.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace bigj;
+
+static auto view(std::string_view str) -> string_view {
+    auto data = reinterpret_cast<const uint8_t*>(str.data());
+    return string_view {data, data + str.size()};
+}
+
+TEST_CASE("Line index lookups", "[line_index]") {
+    // "é" is two bytes, "😀" four bytes and two UTF-16 units, and "é"
+    // is a single grapheme cluster of two code points.
+    auto text = std::string {"ab\n\xC3\xA9\xF0\x9F\x98\x80x\r\ne\xCC\x81z\n"};
+    auto index = line_index<unicode::utf8> {view(text)};
+
+    SECTION("lines") {
+        REQUIRE(index.line_count() == 4);
+        CHECK(index.line_start(1) == 3);
+        CHECK(index.line_start(2) == 12);
+        CHECK(index.line_end(1) == 11);
+        CHECK(index.line_end(0) == 2);
+        CHECK(index.line_end(3) == text.size());
+        CHECK(index.line(0) == 0);
+        CHECK(index.line(2) == 0);
+        CHECK(index.line(3) == 1);
+        CHECK(index.line(text.size()) == 3);
+        CHECK_THROWS_AS(index.line(text.size() + 1), std::out_of_range);
+        CHECK_THROWS_AS(index.line_start(4), std::out_of_range);
+    }
+
+    SECTION("columns") {
+        CHECK(index.position(9) == text_position {1, 2});
+        CHECK(index.position(9, column_unit::utf16) == text_position {1, 3});
+        CHECK(index.position(9, column_unit::grapheme) == text_position {1, 2});
+        CHECK(index.position(16) == text_position {2, 3});
+        CHECK(index.position(16, column_unit::grapheme) == text_position {2, 2});
+        CHECK(index.position(17) == text_position {3, 0});
+    }
+
+    SECTION("offsets") {
+        CHECK(index.offset({1, 2}) == 9);
+        CHECK(index.offset({1, 3}, column_unit::utf16) == 9);
+        CHECK(index.offset({1, 2}, column_unit::utf16) == 5);
+        CHECK(index.offset({2, 1}, column_unit::grapheme) == 15);
+        CHECK(index.offset({0, 100}) == 2);
+        CHECK(index.offset({3, 0}) == text.size());
+        CHECK_THROWS_AS(index.offset({4, 0}), std::out_of_range);
+    }
+}
+
+template<unicode::encoding E>
+static auto check_round_trips(std::vector<typename E::code_unit> data) -> void {
+    // Turn some single unit code points into line breaks.
+    for (size_t i = 0; i < data.size(); i += 5) {
+        if (unicode::detail::load_unit<E>(&data[i]) < 0x80) {
+            E::encode(U'\n', &data[i]);
+        }
+    }
+
+    auto text = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto index = line_index<E> {text};
+
+    REQUIRE(index.line_count() == text.count(U'\n') + 1);
+
+    for (auto it = text.begin(); it != text.end(); it++) {
+        auto offset = static_cast<size_t>(it.address() - data.data());
+        auto line = index.line(offset);
+        auto line_begin = unicode::iterator<E> {data.data() + index.line_start(line)};
+        auto code_points = static_cast<size_t>(std::distance(line_begin, it));
+        auto utf16_units = size_t {0};
+
+        for (auto jt = line_begin; jt != it; jt++) {
+            utf16_units += unicode::utf16le::encoded_size(*jt);
+        }
+
+        REQUIRE(index.position(offset) == text_position {line, code_points});
+        REQUIRE(index.position(offset, column_unit::utf16) == text_position {line, utf16_units});
+
+        for (auto unit : {column_unit::code_point, column_unit::utf16}) {
+            REQUIRE(index.offset(index.position(offset, unit), unit) == offset);
+        }
+    }
+}
+
+TEST_CASE("Line index round trips", "[line_index]") {
+    auto length = GENERATE(range<size_t>(1, 50));
+
+    check_round_trips<unicode::utf8>(GENERATE_COPY(take(5, random_string<unicode::utf8>(length))));
+    check_round_trips<unicode::utf16be>(GENERATE_COPY(take(5, random_string<unicode::utf16be>(length))));
+    check_round_trips<unicode::utf32le>(GENERATE_COPY(take(5, random_string<unicode::utf32le>(length))));
+}
+
+TEST_CASE("Line index updates", "[line_index]") {
+    auto text = std::string {"one\ntwo\nthree\nfour"};
+    auto index = line_index<unicode::utf8> {view(text)};
+
+    auto edit = [&](size_t offset, size_t removed, std::string inserted) {
+        text.replace(offset, removed, inserted);
+        index.update(view(text), offset, removed, inserted.size());
+
+        auto fresh = line_index<unicode::utf8> {view(text)};
+        REQUIRE(index.line_count() == fresh.line_count());
+
+        for (size_t line = 0; line < fresh.line_count(); line++) {
+            REQUIRE(index.line_start(line) == fresh.line_start(line));
+        }
+    };
+
+    edit(3, 1, " ");
+    edit(0, 0, "zero\n");
+    edit(9, 6, "2\n2.5\n");
+    edit(text.size(), 0, "\n");
+    edit(0, text.size(), "");
+
+    CHECK(index.line_count() == 1);
+    CHECK_THROWS_AS(index.update(view(text), 1, 0, 0), std::out_of_range);
+}
@@ -0,0 +1,81 @@
+#include <bigj/literals.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+
+using namespace bigj;
+using namespace bigj::literals;
+
+TEST_CASE("String literal encoding", "[literals]") {
+    auto str = u8"héllo wörld \U0001F642"_s;
+
+    STATIC_REQUIRE(std::same_as<decltype(str), utf8_string>);
+    STATIC_REQUIRE(std::same_as<decltype(u"x"_s), basic_string<unicode::utf16<std::endian::native>>>);
+    STATIC_REQUIRE(std::same_as<decltype(U"x"_s), basic_string<unicode::utf32<std::endian::native>>>);
+
+    auto units = std::array<uint8_t, 18> {
+        'h', 0xC3, 0xA9, 'l', 'l', 'o', ' ', 'w', 0xC3, 0xB6, 'r', 'l', 'd', ' ',
+        0xF0, 0x9F, 0x99, 0x82
+    };
+
+    CHECK(std::ranges::equal(str.code_units(), units));
+    CHECK(str.length() == 13);
+
+    CHECK(u""_s.empty());
+    CHECK(U""_u16le.empty());
+}
+
+TEST_CASE("String literal transcoding", "[literals]") {
+    auto str = u8"héllo wörld \U0001F642"_s;
+
+    auto check = [&](const auto& literal) {
+        using S = std::remove_cvref_t<decltype(literal)>;
+
+        auto converted = S {str};
+
+        CHECK(std::ranges::equal(literal.code_units(), converted.code_units()));
+        CHECK(literal.length() == str.length());
+    };
+
+    check(u8"héllo wörld \U0001F642"_u16be);
+    check(u"héllo wörld \U0001F642"_u16le);
+    check(U"héllo wörld \U0001F642"_u32be);
+    check(u"héllo wörld \U0001F642"_u32le);
+    check(U"héllo wörld \U0001F642"_u8);
+}
+
+TEST_CASE("String literal static storage", "[literals]") {
+    auto make = [] {
+        return u8"a literal that is too long to fit in the small string buffer"_s;
+    };
+
+    auto str_1 = make();
+    auto str_2 = make();
+
+    REQUIRE(str_1.code_units().data() == str_2.code_units().data());
+
+    SECTION("copy") {
+        auto copy = str_1;
+
+        CHECK(copy.code_units().data() == str_1.code_units().data());
+        CHECK(copy.capacity() == copy.code_units().size());
+    }
+
+    SECTION("substring") {
+        auto substr = str_1.substring(std::next(str_1.begin()), str_1.end());
+
+        CHECK(substr.code_units().data() == str_1.code_units().data() + 1);
+        CHECK(substr.length() == str_1.length() - 1);
+    }
+
+    SECTION("modification") {
+        str_1.push_back(U'!');
+
+        CHECK(str_1.code_units().data() != str_2.code_units().data());
+        CHECK(str_1.length() == str_2.length() + 1);
+        CHECK(str_1.back() == U'!');
+        CHECK(str_2.back() == U'r');
+    }
+}
@@ -0,0 +1,81 @@
+#include "detail/random_string_generator.hpp"
+
+#include <bigj/offset_map.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace bigj;
+
+template<unicode::encoding E>
+static auto check_offsets(const std::vector<typename E::code_unit>& data) -> void {
+    auto text = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto index = offset_index<E> {text, 3};
+
+    // The offsets of every code point boundary in each unit.
+    auto expected = std::array<std::vector<size_t>, 3> {};
+    auto code_points = size_t {0};
+    auto utf16_units = size_t {0};
+
+    for (auto it = text.begin(); ; it++) {
+        expected[0].push_back(static_cast<size_t>(it.address() - data.data()));
+        expected[1].push_back(code_points);
+        expected[2].push_back(utf16_units);
+
+        if (it == text.end()) break;
+
+        code_points++;
+        utf16_units += unicode::utf16le::encoded_size(*it);
+    }
+
+    auto units = {offset_unit::code_unit, offset_unit::code_point, offset_unit::utf16};
+
+    for (auto from : units) {
+        for (auto to : units) {
+            auto& source = expected[static_cast<size_t>(from)];
+            auto& target = expected[static_cast<size_t>(to)];
+
+            REQUIRE(convert_offsets(text, source, from, to) == target);
+            REQUIRE(index.convert(source, from, to) == target);
+
+            for (size_t i = 0; i < source.size(); i++) {
+                REQUIRE(convert_offset(text, source[i], from, to) == target[i]);
+                REQUIRE(index.convert(source[i], from, to) == target[i]);
+            }
+        }
+
+        auto past_end = expected[static_cast<size_t>(from)].back() + 1;
+        REQUIRE_THROWS_AS(convert_offset(text, past_end, from, offset_unit::code_unit), std::out_of_range);
+        REQUIRE_THROWS_AS(index.convert(past_end, from, offset_unit::code_unit), std::out_of_range);
+    }
+}
+
+TEST_CASE("Offset conversion", "[offset_map]") {
+    SECTION("random") {
+        auto length = GENERATE(range<size_t>(0, 40));
+
+        check_offsets<unicode::utf8>(GENERATE_COPY(take(5, random_string<unicode::utf8>(length))));
+        check_offsets<unicode::utf16be>(GENERATE_COPY(take(5, random_string<unicode::utf16be>(length))));
+        check_offsets<unicode::utf32le>(GENERATE_COPY(take(5, random_string<unicode::utf32le>(length))));
+    }
+
+    SECTION("inside code points") {
+        // "a😀b" in UTF-8, the emoji taking four bytes and two UTF-16 units.
+        auto data = std::vector<uint8_t> {'a', 0xF0, 0x9F, 0x98, 0x80, 'b'};
+        auto str = string {data.data(), data.data() + data.size()};
+
+        CHECK(convert_offset(str, 3, offset_unit::code_unit, offset_unit::utf16) == 1);
+        CHECK(convert_offset(str, 2, offset_unit::utf16, offset_unit::code_unit) == 1);
+        CHECK(convert_offset(str, 3, offset_unit::utf16, offset_unit::code_unit) == 5);
+        CHECK(convert_offset(str, 2, offset_unit::code_point, offset_unit::utf16) == 3);
+
+        auto offsets = std::vector<size_t> {5, 2};
+        CHECK_THROWS_AS(convert_offsets(str, offsets, offset_unit::code_unit, offset_unit::utf16), std::invalid_argument);
+    }
+}
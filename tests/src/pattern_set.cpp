@@ -0,0 +1,122 @@
+#include "detail/random_string_generator.hpp"
+
+#include <bigj/pattern_set.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace bigj;
+
+template<unicode::encoding E>
+static auto naive_matches(basic_string_view<E> text, const pattern_set<E>& patterns)
+    -> std::vector<typename pattern_set<E>::match>
+{
+    auto matches = std::vector<typename pattern_set<E>::match> {};
+    auto end = text.code_units().end();
+
+    for (auto it = text.begin(); it != text.end(); it++) {
+        for (size_t p = 0; p < patterns.size(); p++) {
+            auto units = patterns.pattern(p).code_units();
+            auto size = static_cast<ptrdiff_t>(units.size());
+
+            if (end - it.address() >= size && std::equal(units.begin(), units.end(), it.address())) {
+                matches.push_back({p, it, unicode::iterator<E> {it.address() + size}});
+            }
+        }
+    }
+
+    return matches;
+}
+
+template<unicode::encoding E>
+static auto check_patterns(const std::vector<typename E::code_unit>& data, size_t count) -> void {
+    auto text = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto views = std::vector<basic_string_view<E>> {};
+
+    // Patterns are pieces of the text of growing length, so some overlap
+    // and some share prefixes and suffixes.
+    for (auto it = text.begin(); it != text.end() && views.size() < count; it++) {
+        auto end = it;
+
+        for (size_t i = 0; i <= views.size() % 3 && end != text.end(); i++) {
+            end++;
+        }
+
+        views.push_back(text.substring(it, end));
+    }
+
+    auto patterns = pattern_set<E> {views};
+    auto expected = naive_matches(text, patterns);
+
+    REQUIRE(patterns.size() == views.size());
+    REQUIRE(patterns.find_all(text) == expected);
+    REQUIRE(patterns.contains(text) == !expected.empty());
+    REQUIRE(patterns.find(text) == (expected.empty()
+        ? std::nullopt : std::optional {expected.front()}));
+}
+
+TEST_CASE("Pattern set matches", "[pattern_set]") {
+    auto length = GENERATE(range<size_t>(1, 40));
+    auto count = GENERATE(size_t {1}, size_t {3}, size_t {20});
+
+    check_patterns<unicode::utf8>(GENERATE_COPY(take(3, random_string<unicode::utf8>(length))), count);
+    check_patterns<unicode::utf16le>(GENERATE_COPY(take(3, random_string<unicode::utf16le>(length))), count);
+    check_patterns<unicode::utf32be>(GENERATE_COPY(take(3, random_string<unicode::utf32be>(length))), count);
+}
+
+TEST_CASE("Pattern set keywords", "[pattern_set]") {
+    auto view = [](const char* str) {
+        auto data = reinterpret_cast<const uint8_t*>(str);
+        return string_view {data, data + std::strlen(str)};
+    };
+
+    auto small = pattern_set<unicode::utf8> {view("he"), view("she"), view("his"), view("hers")};
+    auto words = std::vector<string_view> {};
+
+    for (auto word : {"he", "she", "his", "hers", "a", "an", "and", "ant", "the", "then", "there", "ushers"}) {
+        words.push_back(view(word));
+    }
+
+    for (int i = 0; i < 20; i++) {
+        words.push_back(view("zzz"));
+    }
+
+    auto large = pattern_set<unicode::utf8> {words};
+    auto text = view("ushers and the ants");
+
+    SECTION("small set") {
+        auto matches = small.find_all(text);
+
+        REQUIRE(matches.size() == 4);
+        CHECK(matches[0].pattern == 1);
+        CHECK(matches[1].pattern == 0);
+        CHECK(matches[2].pattern == 3);
+        CHECK(matches[3].pattern == 0);
+        CHECK(matches[1].begin.address() == text.code_units().begin() + 2);
+        CHECK(small.find(text)->pattern == 1);
+        CHECK(!small.contains(view("hx sh")));
+    }
+
+    SECTION("large set") {
+        auto matches = large.find_all(text);
+
+        REQUIRE(matches == naive_matches(text, large));
+        CHECK(large.find(text)->pattern == 11);
+        CHECK(large.contains(view("zzz")));
+        CHECK(!large.contains(view("xyz")));
+        CHECK(!large.find(view("")));
+    }
+
+    SECTION("invalid patterns") {
+        CHECK_THROWS_AS(pattern_set<unicode::utf8> {view("")}, std::invalid_argument);
+        CHECK_THROWS_AS(small.pattern(4), std::out_of_range);
+        CHECK(pattern_set<unicode::utf8> {std::vector<string_view> {}}.find_all(text).empty());
+    }
+}
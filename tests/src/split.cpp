@@ -0,0 +1,108 @@
+#include "detail/random_string_generator.hpp"
+
+#include <bigj/split.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace bigj;
+
+static auto view(std::string_view str) -> string_view {
+    auto data = reinterpret_cast<const uint8_t*>(str.data());
+    return string_view {data, data + str.size()};
+}
+
+template<std::ranges::range R>
+static auto to_strings(R&& pieces) -> std::vector<std::string> {
+    auto result = std::vector<std::string> {};
+
+    for (string_view piece : pieces) {
+        auto units = piece.code_units();
+        result.emplace_back(units.begin(), units.end());
+    }
+
+    return result;
+}
+
+static auto expected_split(std::string_view str, std::string_view delimiter) -> std::vector<std::string> {
+    auto result = std::vector<std::string> {};
+
+    for (auto piece : std::views::split(str, delimiter)) {
+        result.emplace_back(piece.begin(), piece.end());
+    }
+
+    return result;
+}
+
+TEST_CASE("Split", "[split]") {
+    static_assert(std::ranges::forward_range<decltype(split(string_view {}, U','))>);
+    static_assert(std::ranges::view<decltype(split(string_view {}, U','))>);
+
+    SECTION("code point") {
+        for (auto str : {"a,b,c", ",a,,b,", "", ",", "abc", "a,b,c,d,e,f,g,h,i,j,k,l"}) {
+            REQUIRE(to_strings(split(view(str), U',')) == expected_split(str, ","));
+        }
+    }
+
+    SECTION("string") {
+        for (auto str : {"a, b, c", ", a, , b, ", "", ", ", "abc", "a,, b"}) {
+            REQUIRE(to_strings(split(view(str), view(", "))) == expected_split(str, ", "));
+        }
+
+        CHECK_THROWS_AS(split(view("abc"), string_view {}), std::invalid_argument);
+    }
+
+    SECTION("any") {
+        auto pieces = to_strings(split_any(view("a b\tc  d"), view(" \t")));
+        CHECK(pieces == std::vector<std::string> {"a", "b", "c", "", "d"});
+    }
+
+    SECTION("lines") {
+        auto pieces = to_strings(lines(view("one\ntwo\r\n\nthree\r\n")));
+        CHECK(pieces == std::vector<std::string> {"one", "two", "", "three"});
+        CHECK(to_strings(lines(view("last"))) == std::vector<std::string> {"last"});
+        CHECK(to_strings(lines(view(""))).empty());
+    }
+
+    SECTION("composition") {
+        auto str = string {view("x=1;y=22;z=333")};
+        auto sizes = split(str, U';')
+            | std::views::transform([](string_view piece) { return piece.code_units().size(); });
+
+        CHECK(std::ranges::equal(sizes, std::vector<size_t> {3, 4, 5}));
+        CHECK(std::ranges::distance(split(str, U'=')) == 4);
+    }
+}
+
+TEST_CASE("Split random strings", "[split]") {
+    auto length = GENERATE(range<size_t>(1, 60));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf16le>(length)));
+
+    auto str = utf16le_string_view {data.data(), data.data() + data.size()};
+    auto delimiter = *std::next(str.begin(), length / 2);
+
+    auto pieces = split(str, delimiter);
+    auto joined = std::vector<unicode::code_point> {};
+
+    for (auto piece : pieces) {
+        REQUIRE(!piece.contains(delimiter));
+
+        if (!joined.empty() || piece.code_units().begin() != str.code_units().begin()) {
+            joined.push_back(delimiter);
+        }
+
+        joined.insert(joined.end(), piece.begin(), piece.end());
+    }
+
+    REQUIRE(std::ranges::equal(joined, str.code_points()));
+    REQUIRE(static_cast<size_t>(std::ranges::distance(pieces)) == str.count(delimiter) + 1);
+}
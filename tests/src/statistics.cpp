@@ -0,0 +1,74 @@
+#include <bigj/string.hpp>
+#include <bigj/unicode/statistics.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <bit>
+#include <thread>
+#include <vector>
+
+using namespace bigj;
+
+TEST_CASE("Statistics", "[statistics]") {
+    // Everything stays zero unless statistics are enabled.
+    constexpr auto enabled = uint64_t {unicode::config::statistics};
+    constexpr auto histogram = uint64_t {unicode::config::size_histogram};
+
+    auto short_units = std::vector<uint8_t>(5, 'a');
+    auto long_units = std::vector<uint8_t>(100, 'a');
+
+    unicode::reset_statistics();
+
+    {
+        auto small = string {short_units.data(), short_units.data() + short_units.size()};
+        auto large = string {long_units.data(), long_units.data() + long_units.size()};
+        auto copy = large;
+        auto utf16 = utf16le_string {large};
+
+        // The length is cached by each string, not in the shared block.
+        CHECK(large.length() == 100);
+        CHECK(large.length() == 100);
+        CHECK(copy.length() == 100);
+    }
+
+    auto stats = unicode::statistics();
+
+    CHECK(stats.small_strings == enabled * 1);
+    CHECK(stats.large_allocations == enabled * 2);
+    CHECK((stats.allocated_bytes >= 300) == (enabled == 1));
+    CHECK(stats.shared_references == enabled * 1);
+    CHECK(stats.released_references == enabled * 3);
+    CHECK(stats.freed_blocks == enabled * 2);
+    CHECK(stats.validated_bytes == enabled * 105);
+    CHECK(stats.transcoded_bytes == enabled * 100);
+    CHECK(stats.length_cache_misses == enabled * 2);
+    CHECK(stats.length_cache_hits == enabled * 1);
+
+    CHECK(stats.size_histogram[std::bit_width(5u)] == histogram * 1);
+    CHECK(stats.size_histogram[std::bit_width(100u)] == histogram * 1);
+    CHECK(stats.size_histogram[std::bit_width(200u)] == histogram * 1);
+
+    SECTION("threads") {
+        auto threads = std::vector<std::thread> {};
+
+        for (auto i = 0; i < 4; i++) {
+            threads.emplace_back([&] {
+                for (auto j = 0; j < 10; j++) {
+                    auto str = string {short_units.data(), short_units.data() + short_units.size()};
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(unicode::statistics().small_strings == enabled * 41);
+    }
+
+    SECTION("reset") {
+        unicode::reset_statistics();
+        CHECK(unicode::statistics().small_strings == 0);
+        CHECK(unicode::statistics().validated_bytes == 0);
+    }
+}
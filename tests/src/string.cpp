@@ -4,10 +4,16 @@
 #include <bigj/string.hpp>
 #include <bigj/string_view.hpp>
 
+#include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
 
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
 using namespace bigj;
 using unicode::error_code;
 using unicode::utf8;
@@ -93,6 +99,80 @@ TEST_CASE("String converting constructor", "[string]") {
     CHECK(str_1.back() == str_2.back());
 }
 
+TEMPLATE_TEST_CASE(
+    "String inline capacity",
+    "[string]",
+    compact_string,
+    string,
+    (basic_string<unicode::utf8, 48>),
+    (basic_string<unicode::utf8, 128>),
+    compact_utf16le_string,
+    (basic_string<unicode::utf16le, 64>),
+    compact_utf32be_string,
+    (basic_string<unicode::utf32be, 64>)
+) {
+    using E = typename TestType::encoding_type;
+
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, random_string<E>(length)));
+    auto view = basic_string_view<E> {data.data(), data.data() + data.size()};
+    auto small_bytes = sizeof(TestType) - sizeof(typename E::code_unit);
+
+    auto str = TestType {view};
+
+    CHECK(str == view);
+    CHECK(str.length() == length);
+    CHECK(str.length() == length);
+    CHECK(str.shared_bytes() == (sizeof(typename E::code_unit) * data.size() > small_bytes ? sizeof(typename E::code_unit) * data.size() : 0));
+
+    SECTION("substrings") {
+        auto first = std::next(str.begin(), static_cast<ptrdiff_t>(length / 3));
+        auto last = std::next(first, static_cast<ptrdiff_t>(length / 2));
+        auto substr = str.substring(first, last);
+
+        auto view_first = std::next(view.begin(), static_cast<ptrdiff_t>(length / 3));
+        CHECK(substr == view.substring(view_first, std::next(view_first, static_cast<ptrdiff_t>(length / 2))));
+        CHECK(substr.length() == length / 2);
+
+        substr.remove_prefix(std::next(substr.begin(), static_cast<ptrdiff_t>(length / 4)));
+        substr.remove_suffix(std::prev(substr.end(), static_cast<ptrdiff_t>(length / 8)));
+
+        CHECK(substr.length() == length / 2 - length / 4 - length / 8);
+        CHECK(std::ranges::equal(substr, std::ranges::subrange {
+            std::next(first, static_cast<ptrdiff_t>(length / 4)),
+            std::prev(last, static_cast<ptrdiff_t>(length / 8))
+        }));
+    }
+
+    SECTION("modification") {
+        auto copy = str;
+
+        str.append(view);
+        str.push_back(U'x');
+        str.replace(str.begin(), std::next(str.begin()), basic_string_view<E> {});
+
+        CHECK(copy == view);
+        CHECK(str.length() == 2 * length);
+        CHECK(str.back() == U'x');
+        CHECK(std::ranges::equal(str.substring(str.begin(), std::next(str.begin(), static_cast<ptrdiff_t>(length - 1))), std::ranges::subrange {std::next(view.begin()), view.end()}));
+    }
+
+    SECTION("other inline capacities") {
+        auto compact = basic_string<E, compact_inline_bytes> {str};
+        auto wide = basic_string<E, 64> {compact};
+        auto utf8 = string {wide};
+
+        CHECK(compact == str);
+        CHECK(wide == str);
+        CHECK(utf8 == str);
+        CHECK(wide.length() == length);
+
+        if (str.shared_bytes() != 0 && wide.shared_bytes() != 0) {
+            CHECK(wide.code_units().data() == str.code_units().data());
+        }
+    }
+}
+
 TEST_CASE("String copy and move constructors", "[string]") {
     auto length = GENERATE(range<size_t>(1, 100));
     auto data = GENERATE_COPY(take(100, random_string<unicode::utf8>(length)));
@@ -187,3 +267,462 @@ TEST_CASE("String swap", "[string]") {
     CHECK(str_2.code_units().size() == size_1);
     CHECK(str_2.length() == length_1);
 }
+
+TEST_CASE("String append", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, chunk(2, random_string<unicode::utf8>(length))));
+
+    auto str_1 = string {data[0].data(), data[0].data() + data[0].size()};
+    auto str_2 = string {data[1].data(), data[1].data() + data[1].size()};
+
+    auto expected = data[0];
+    expected.insert(expected.end(), data[1].begin(), data[1].end());
+
+    SECTION("same encoding") {
+        str_1.append(str_2);
+
+        CHECK(std::ranges::equal(str_1.code_units(), expected));
+        CHECK(str_1.length() == 2 * length);
+    }
+
+    SECTION("other encoding") {
+        str_1.append(utf16le_string {str_2});
+
+        CHECK(std::ranges::equal(str_1.code_units(), expected));
+        CHECK(str_1.length() == 2 * length);
+    }
+
+    SECTION("self") {
+        str_1.append(str_1);
+
+        CHECK(std::ranges::equal(str_1.code_units().begin(), str_1.code_units().begin() + data[0].size(), data[0].begin(), data[0].end()));
+        CHECK(std::ranges::equal(str_1.code_units().begin() + data[0].size(), str_1.code_units().end(), data[0].begin(), data[0].end()));
+    }
+
+    SECTION("in place") {
+        str_1.reserve(expected.size());
+        auto ptr = str_1.code_units().data();
+
+        str_1.append(str_2);
+
+        CHECK(std::ranges::equal(str_1.code_units(), expected));
+        REQUIRE(str_1.code_units().data() == ptr);
+    }
+
+    SECTION("copy on write") {
+        str_1.reserve(expected.size());
+        auto copy = str_1;
+
+        str_1.append(str_2);
+
+        CHECK(std::ranges::equal(str_1.code_units(), expected));
+        CHECK(std::ranges::equal(copy.code_units(), data[0]));
+        REQUIRE(str_1.code_units().data() != copy.code_units().data());
+    }
+}
+
+TEST_CASE("String push back", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+    auto sv = string_view {data.data(), data.data() + data.size()};
+
+    auto str = string {};
+
+    for (auto cp : sv.code_points()) {
+        str.push_back(cp);
+    }
+
+    CHECK(std::ranges::equal(str.code_units(), data));
+    CHECK(str.length() == length);
+
+    REQUIRE_THROWS_AS(str.push_back(0xD800), unicode::parse_error);
+    REQUIRE_THROWS_AS(str.push_back(0x110000), unicode::parse_error);
+}
+
+TEST_CASE("String replace", "[string]") {
+    auto length = GENERATE(range<size_t>(2, 100));
+    auto data = GENERATE_COPY(take(10, chunk(2, random_string<unicode::utf8>(length))));
+
+    auto str = string {data[0].data(), data[0].data() + data[0].size()};
+    auto replacement = string_view {data[1].data(), data[1].data() + data[1].size()};
+
+    auto first = std::next(str.begin());
+    auto last = std::prev(str.end());
+
+    auto expected = std::vector<uint8_t> {str.code_units().begin(), first.address()};
+    expected.insert(expected.end(), data[1].begin(), data[1].end());
+    expected.insert(expected.end(), last.address(), str.code_units().end());
+
+    SECTION("shared") {
+        auto copy = str;
+
+        str.replace(first, last, replacement);
+
+        CHECK(std::ranges::equal(str.code_units(), expected));
+        CHECK(std::ranges::equal(copy.code_units(), data[0]));
+    }
+
+    SECTION("in place") {
+        auto offset = first.address() - str.code_units().data();
+        auto count = last.address() - first.address();
+
+        str.reserve(expected.size());
+        auto ptr = str.code_units().data();
+
+        str.replace(
+            string::const_iterator {ptr + offset},
+            string::const_iterator {ptr + offset + count},
+            replacement
+        );
+
+        CHECK(std::ranges::equal(str.code_units(), expected));
+        REQUIRE(str.code_units().data() == ptr);
+    }
+
+    SECTION("out of range") {
+        REQUIRE_THROWS_AS(str.replace(str.end(), str.begin(), replacement), std::out_of_range);
+    }
+}
+
+TEST_CASE("String adopting external buffers", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+
+    struct pool {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        int releases = 0;
+    };
+
+    auto release = [](const uint8_t* data, size_t size, void* context) {
+        auto p = static_cast<pool*>(context);
+        p->data = data;
+        p->size = size;
+        p->releases += 1;
+    };
+
+    auto p = pool {};
+    auto begin = data.data();
+    auto end = data.data() + data.size();
+
+    SECTION("ownership") {
+        {
+            auto str = string::adopt(begin, end, release, &p);
+            auto copy = str;
+            auto substr = str.substring(std::next(str.begin()), str.end());
+
+            CHECK(std::ranges::equal(str.code_units(), data));
+            CHECK(str.length() == length);
+
+            if (data.size() >= sizeof(string)) {
+                CHECK(str.code_units().data() == begin);
+                CHECK(copy.code_units().data() == begin);
+                CHECK(p.releases == 0);
+            }
+        }
+
+        CHECK(p.data == begin);
+        CHECK(p.size == data.size());
+        REQUIRE(p.releases == 1);
+    }
+
+    SECTION("modification") {
+        auto str = string::adopt(begin, end, release, &p);
+        str.push_back(U'!');
+
+        CHECK(std::ranges::equal(data, std::ranges::subrange {str.code_units().begin(), std::prev(str.code_units().end())}));
+        CHECK(str.code_units().data() != begin);
+    }
+
+    SECTION("invalid buffer") {
+        data.back() = 0xFF;
+
+        auto str = string {};
+        REQUIRE_THROWS_AS((str = string::adopt(begin, end, release, &p)), unicode::parse_error);
+        REQUIRE(p.releases == 0);
+    }
+
+    SECTION("null release") {
+        auto str = string {};
+        REQUIRE_THROWS_AS((str = string::adopt(begin, end, nullptr)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("String block alignment and padding", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto units = str.code_units();
+    auto padding = str.readable_padding();
+
+    if (data.size() >= sizeof(string)) {
+        CHECK(reinterpret_cast<uintptr_t>(units.data()) % unicode::config::block_alignment == 0);
+        CHECK(padding >= unicode::config::block_padding);
+    }
+
+    auto bytes = reinterpret_cast<const volatile std::byte*>(units.data() + units.size());
+
+    for (size_t i = 0; i < padding; i++) {
+        static_cast<void>(bytes[i]);
+    }
+
+    REQUIRE(padding > 0);
+}
+
+TEST_CASE("String compaction", "[string]") {
+    auto data = GENERATE(take(10, random_string<unicode::utf8>(1000)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto small = str.substring(str.begin(), std::next(str.begin()));
+    auto large = str.substring(std::next(str.begin(), 100), std::next(str.begin(), 200));
+    auto size = large.code_units().size();
+
+    CHECK(str.shared_bytes() == data.size());
+    CHECK(str.owned_fraction() == 1.0);
+
+    CHECK(small.shared_bytes() == 0);
+    CHECK(small.owned_fraction() == 1.0);
+
+    if (large.code_units().data() != std::next(str.begin(), 100).address()) {
+        REQUIRE(unicode::config::min_shared_fraction > 0);
+        REQUIRE(large.shared_bytes() == size);
+    } else {
+        CHECK(large.shared_bytes() == data.size());
+        CHECK(large.owned_fraction() == (double) size / (double) data.size());
+
+        large.compact();
+
+        CHECK(std::ranges::equal(large.code_units(), std::ranges::subrange {std::next(str.begin(), 100).address(), std::next(str.begin(), 200).address()}));
+        CHECK(large.shared_bytes() == size);
+        CHECK(large.owned_fraction() == 1.0);
+        CHECK(large.length() == 100);
+    }
+}
+
+#if CPPUNICODE_NULL_TERMINATORS
+
+TEST_CASE("String lazy null terminators", "[string]") {
+    auto data = GENERATE(take(10, random_string<unicode::utf8>(100)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto begin = str.code_units().data();
+
+    auto is_terminated = [](const string& s) {
+        auto c_str = s.c_str();
+        auto units = s.code_units();
+        return std::ranges::equal(units, std::ranges::subrange {c_str, c_str + units.size()})
+            && c_str[units.size()] == 0;
+    };
+
+    SECTION("unique") {
+        str.remove_suffix(std::prev(str.end()));
+
+        CHECK(str.code_units().data() == begin);
+        CHECK(str.c_str() == begin);
+        REQUIRE(is_terminated(str));
+    }
+
+    SECTION("shared") {
+        auto substr = str.substring(str.begin(), std::prev(str.end()));
+
+        CHECK(substr.code_units().data() == begin);
+        CHECK(substr.c_str() != begin);
+        CHECK(substr.c_str() == substr.c_str());
+        CHECK(substr.c_str() == substr.code_units().data());
+        CHECK(substr.shared_bytes() < str.shared_bytes());
+        CHECK(is_terminated(substr));
+
+        CHECK(str.c_str() == begin);
+        CHECK(std::ranges::equal(str.code_units(), data));
+        REQUIRE(is_terminated(str));
+    }
+
+    SECTION("adopted") {
+        auto adopted = string::adopt(data.data(), data.data() + data.size(), [](const uint8_t*, size_t, void*) {});
+
+        CHECK(adopted.code_units().data() == data.data());
+        REQUIRE(is_terminated(adopted));
+    }
+}
+
+#endif
+
+TEST_CASE("String hash", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto sv = string_view {data.data(), data.data() + data.size()};
+
+    CHECK(std::hash<string> {}(str) == std::hash<string_view> {}(sv));
+    CHECK(string_hash {}(str) == string_hash {}(sv));
+    CHECK(string_equal {}(str, sv));
+    CHECK(string_equal {}(sv, str));
+
+    SECTION("heterogeneous lookup") {
+        auto map = std::unordered_map<string, size_t, string_hash, string_equal> {};
+        map.emplace(str, length);
+
+        auto it = map.find(sv);
+
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == length);
+        REQUIRE(map.find(string_view {}) == map.end());
+    }
+}
+
+TEST_CASE("String cross encoding comparison", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, chunk(2, random_string<unicode::utf8>(length))));
+
+    auto str_1 = string {data[0].data(), data[0].data() + data[0].size()};
+    auto str_2 = string {data[1].data(), data[1].data() + data[1].size()};
+
+    auto utf16_1 = utf16be_string {str_1};
+    auto utf32_1 = utf32le_string {str_1};
+    auto utf16_2 = utf16le_string {str_2};
+
+    SECTION("hash") {
+        CHECK(std::hash<utf16be_string> {}(utf16_1) == std::hash<string> {}(str_1));
+        CHECK(std::hash<utf32le_string> {}(utf32_1) == std::hash<string> {}(str_1));
+        CHECK(string_hash {}(static_cast<utf16le_string_view>(utf16_2)) == string_hash {}(str_2));
+    }
+
+    SECTION("equality") {
+        CHECK(str_1 == utf16_1);
+        CHECK(utf16_1 == utf32_1);
+        CHECK(static_cast<utf32le_string_view>(utf32_1) == str_1);
+        CHECK(string_equal {}(str_1, utf32_1));
+        CHECK((str_2 != utf16_1) == !std::ranges::equal(str_2.code_units(), str_1.code_units()));
+    }
+
+    SECTION("ordering") {
+        auto expected = std::lexicographical_compare_three_way(
+            str_1.begin(), str_1.end(),
+            str_2.begin(), str_2.end(),
+            [](auto a, auto b) { return a.value() <=> b.value(); }
+        );
+
+        CHECK((utf16_1 <=> utf16_2) == expected);
+        CHECK((utf32_1 <=> utf16_2) == expected);
+        CHECK((str_1 <=> utf16_2) == expected);
+        CHECK((utf16_2 <=> utf32_1) == (0 <=> expected));
+    }
+
+    SECTION("ascii") {
+        auto ascii = std::vector<uint8_t>(length, 'a');
+        auto ascii_str = string {ascii.data(), ascii.data() + ascii.size()};
+        auto ascii_utf16 = utf16be_string {ascii_str};
+
+        CHECK(ascii_str == ascii_utf16);
+        CHECK(std::hash<string> {}(ascii_str) == std::hash<utf16be_string> {}(ascii_utf16));
+
+        ascii_str.push_back(U'b');
+
+        CHECK(ascii_str != ascii_utf16);
+        CHECK(ascii_str > ascii_utf16);
+    }
+
+    SECTION("lookup") {
+        auto map = std::unordered_map<string, size_t, string_hash, string_equal> {};
+        map.emplace(str_1, length);
+
+        auto it = map.find(utf16_1);
+
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == length);
+    }
+}
+
+TEST_CASE("String same encoding comparison", "[string]") {
+    auto length = GENERATE(range<size_t>(1, 100));
+    auto data = GENERATE_COPY(take(10, chunk(2, random_string<unicode::utf8>(length))));
+
+    auto str_1 = string {data[0].data(), data[0].data() + data[0].size()};
+    auto str_2 = string {data[1].data(), data[1].data() + data[1].size()};
+
+    auto expected = std::lexicographical_compare_three_way(
+        str_1.begin(), str_1.end(),
+        str_2.begin(), str_2.end(),
+        [](auto a, auto b) { return a.value() <=> b.value(); }
+    );
+
+    SECTION("ordering") {
+        CHECK((str_1 <=> str_2) == expected);
+        CHECK((utf16le_string {str_1} <=> utf16le_string {str_2}) == expected);
+        CHECK((utf16be_string {str_1} <=> utf16be_string {str_2}) == expected);
+        CHECK((utf32le_string {str_1} <=> utf32le_string {str_2}) == expected);
+        CHECK((utf32be_string {str_1} <=> utf32be_string {str_2}) == expected);
+        CHECK((static_cast<string_view>(str_2) <=> str_1) == (0 <=> expected));
+    }
+
+    SECTION("equality") {
+        auto copy = string {str_1};
+        auto rebuilt = string {data[0].data(), data[0].data() + data[0].size()};
+
+        CHECK(copy == str_1);
+        CHECK(rebuilt == str_1);
+        CHECK((copy <=> str_1) == std::strong_ordering::equal);
+        CHECK(utf16be_string {str_1} == utf16be_string {rebuilt});
+        CHECK((str_1 == str_2) == (expected == 0));
+        CHECK(str_1.substring(str_1.begin(), std::prev(str_1.end())) != str_1);
+    }
+
+    SECTION("sorting") {
+        auto strings = std::vector<utf16le_string> {};
+        auto reference = std::vector<string> {};
+
+        for (auto& str : {str_1, str_2}) {
+            for (auto it = str.begin(); it != str.end(); it++) {
+                reference.push_back(str.substring(str.begin(), it));
+                strings.emplace_back(reference.back());
+            }
+        }
+
+        std::ranges::sort(strings);
+        std::ranges::sort(reference);
+
+        REQUIRE(std::equal(strings.begin(), strings.end(), reference.begin(), reference.end()));
+    }
+}
+
+TEST_CASE("String search", "[string]") {
+    auto length = GENERATE(range<size_t>(2, 100));
+    auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto middle = std::next(str.begin(), length / 2);
+    auto prefix = str.substring(str.begin(), middle);
+    auto suffix = str.substring(middle, str.end());
+
+    auto utf16 = utf16le_string {str};
+    auto utf16_suffix = utf16le_string {suffix};
+
+    CHECK(str.find(suffix) == middle);
+    CHECK(str.rfind(prefix) == str.begin());
+    CHECK(str.contains(str));
+    CHECK(str.starts_with(prefix));
+    CHECK(str.ends_with(suffix));
+    CHECK(!prefix.contains(str));
+    CHECK(utf16.find(utf16_suffix).address() == utf16.code_units().end() - utf16_suffix.code_units().size());
+    CHECK(utf16.ends_with(utf16_suffix));
+    CHECK(str.find(str.front()) == str.begin());
+    CHECK(str.contains(str.back()));
+    CHECK(utf16.count(*middle) == static_cast<size_t>(std::ranges::count(str.code_points(), *middle)));
+}
+
+TEST_CASE("String block decoding", "[string]") {
+    auto length = GENERATE(range<size_t>(0, 200));
+    auto data = GENERATE_COPY(take(5, random_string<unicode::utf8>(length)));
+
+    auto str = string {data.data(), data.data() + data.size()};
+    auto buffer = std::array<unicode::code_point, 64> {};
+    auto decoded = std::vector<unicode::code_point> {};
+
+    for (auto block : str.decode_blocks(buffer)) {
+        decoded.insert(decoded.end(), block.begin(), block.end());
+    }
+
+    REQUIRE(std::ranges::equal(decoded, str.code_points()));
+}
@@ -0,0 +1,165 @@
+#include "detail/corpus_generator.hpp"
+
+#include <bigj/literals.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_column.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+using namespace bigj;
+using namespace bigj::literals;
+
+// Strings of every profile and a mix of lengths, empty ones included.
+template<unicode::encoding E>
+static auto column_strings(size_t count) -> std::vector<basic_string<E>> {
+    auto result = std::vector<basic_string<E>> {};
+    auto random = corpus_random {count};
+
+    for (size_t i = 0; i < count; i++) {
+        auto profile = language_profiles[i % language_profiles.size()];
+        auto data = corpus_string<E>(profile, random.between(0, 40), i);
+        result.emplace_back(data.data(), data.data() + data.size());
+    }
+
+    return result;
+}
+
+TEMPLATE_TEST_CASE(
+    "String column",
+    "[string_column]",
+    unicode::utf8,
+    unicode::utf16le,
+    unicode::utf32be
+) {
+    using E = TestType;
+
+    auto strings = column_strings<E>(1000);
+    auto column = string_column<E> {strings};
+
+    SECTION("elements") {
+        REQUIRE(column.size() == strings.size());
+        REQUIRE(std::ranges::equal(column, strings, std::equal_to<> {}));
+        REQUIRE(column.offsets().back() == column.code_units().size());
+        REQUIRE(column.at(10) == strings[10]);
+        REQUIRE(column.back() == strings.back());
+        REQUIRE_THROWS_AS(column.at(strings.size()), std::out_of_range);
+
+        auto it = column.begin() + 500;
+        REQUIRE(it - column.begin() == 500);
+        REQUIRE(it[-1] == strings[499]);
+        REQUIRE(*std::prev(column.end()) == strings.back());
+    }
+
+    SECTION("batches") {
+        auto units = std::vector<typename E::code_unit> {};
+        auto sizes = std::vector<size_t> {};
+
+        for (auto& str : strings) {
+            auto str_units = str.code_units();
+            units.insert(units.end(), str_units.begin(), str_units.end());
+            sizes.push_back(str_units.size());
+        }
+
+        auto batched = string_column<E> {};
+        batched.append_batch(units, sizes);
+        batched.append_batch(units, sizes);
+
+        REQUIRE(batched.size() == 2 * strings.size());
+        REQUIRE(std::ranges::equal(batched | std::views::take(strings.size()), strings, std::equal_to<> {}));
+        REQUIRE(std::ranges::equal(batched | std::views::drop(strings.size()), strings, std::equal_to<> {}));
+
+        auto unchanged = [&] {
+            return batched.size() == 2 * strings.size() && batched.code_units().size() == 2 * units.size();
+        };
+
+        sizes.back()++;
+        REQUIRE_THROWS_AS(batched.append_batch(units, sizes), std::invalid_argument);
+        REQUIRE(unchanged());
+
+        sizes.back() -= 2;
+        REQUIRE_THROWS_AS(batched.append_batch(units, sizes), std::invalid_argument);
+        REQUIRE(unchanged());
+    }
+
+    SECTION("transcoding") {
+        auto threads = GENERATE(size_t {1}, size_t {3}, size_t {0});
+
+        auto utf8 = column.template transcode<unicode::utf8>(threads);
+        auto utf16 = column.template transcode<unicode::utf16be>(threads);
+        auto utf32 = column.template transcode<unicode::utf32le>(threads);
+
+        REQUIRE(std::ranges::equal(utf8, strings, std::equal_to<> {}));
+        REQUIRE(std::ranges::equal(utf16, strings, std::equal_to<> {}));
+        REQUIRE(std::ranges::equal(utf32, strings, std::equal_to<> {}));
+        REQUIRE(std::ranges::equal(utf32.template transcode<E>(threads), strings, std::equal_to<> {}));
+    }
+
+    SECTION("clear") {
+        column.clear();
+
+        REQUIRE(column.empty());
+        REQUIRE(column.begin() == column.end());
+        REQUIRE(column.template transcode<unicode::utf8>().empty());
+    }
+}
+
+TEST_CASE("String column batch validation", "[string_column]") {
+    auto units = std::vector<unicode::utf8::code_unit> {'a', 0xC3, 0xA9, 'b'};
+    auto column = string_column<unicode::utf8> {};
+
+    SECTION("boundary inside a code point") {
+        auto sizes = std::vector<size_t> {2, 2};
+        REQUIRE_THROWS_AS(column.append_batch(units, sizes), unicode::parse_error);
+        REQUIRE(column.empty());
+    }
+
+    SECTION("invalid code units") {
+        units[2] = 'c';
+        auto sizes = std::vector<size_t> {1, 3};
+        REQUIRE_THROWS_AS(column.append_batch(units, sizes), unicode::parse_error);
+        REQUIRE(column.empty());
+    }
+
+    SECTION("valid boundaries") {
+        auto sizes = std::vector<size_t> {1, 0, 2, 1};
+        column.append_batch(units, sizes);
+
+        REQUIRE(column.size() == 4);
+        REQUIRE(column[1].empty());
+        REQUIRE(column[2] == u8"é"_s);
+    }
+}
+
+TEST_CASE("String column parallel transcoding", "[string_column]") {
+    auto profile = GENERATE(from_range(language_profiles));
+
+    auto column = string_column<unicode::utf8> {};
+    auto strings = std::vector<string> {};
+
+    // Enough code units to be split between threads.
+    while (column.code_units().size() < 4 * string_column<unicode::utf8>::parallel_threshold) {
+        auto data = corpus_string<unicode::utf8>(profile, strings.size() % 50, strings.size());
+        strings.emplace_back(data.data(), data.data() + data.size());
+        column.push_back(strings.back());
+    }
+
+    auto expected = string_column<unicode::utf16le> {strings | std::views::transform([](const string& str) {
+        return utf16le_string {str};
+    })};
+
+    auto transcoded = column.transcode<unicode::utf16le>(4);
+
+    REQUIRE(std::ranges::equal(transcoded.offsets(), expected.offsets()));
+    REQUIRE(std::ranges::equal(transcoded.code_units(), expected.code_units()));
+}
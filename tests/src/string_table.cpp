@@ -0,0 +1,179 @@
+#include "detail/corpus_generator.hpp"
+
+#include <bigj/literals.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_table.hpp>
+#include <bigj/string_view.hpp>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <cstring>
+
+using namespace bigj;
+using namespace bigj::literals;
+
+template<unicode::encoding E>
+static auto table_strings(size_t count) -> std::vector<basic_string<E>> {
+    auto result = std::vector<basic_string<E>> {};
+    auto random = corpus_random {count};
+
+    for (size_t i = 0; i < count; i++) {
+        auto profile = language_profiles[i % language_profiles.size()];
+        auto data = corpus_string<E>(profile, random.between(0, 30), i);
+        result.emplace_back(data.data(), data.data() + data.size());
+    }
+
+    return result;
+}
+
+TEMPLATE_TEST_CASE(
+    "String table",
+    "[string_table]",
+    unicode::utf8,
+    unicode::utf16le,
+    unicode::utf16be,
+    unicode::utf32le
+) {
+    using E = TestType;
+
+    auto hash_index = GENERATE(true, false);
+    auto lengths = GENERATE(true, false);
+
+    auto strings = table_strings<E>(500);
+    auto bytes = write_string_table<E>(strings, {hash_index, lengths});
+    auto table = string_table<E> {bytes};
+
+    REQUIRE(table.size() == strings.size());
+    REQUIRE(table.has_hash_index() == hash_index);
+    REQUIRE(table.has_lengths() == lengths);
+    REQUIRE(std::ranges::equal(table, strings, std::equal_to<> {}));
+
+    SECTION("lengths") {
+        for (size_t i = 0; i < strings.size(); i++) {
+            auto ascii = std::ranges::all_of(strings[i], [](unicode::code_point cp) { return cp < 0x80; });
+
+            REQUIRE(table.length(i) == strings[i].length());
+            REQUIRE(table.is_ascii(i) == ascii);
+        }
+    }
+
+    SECTION("find") {
+        for (size_t i = 0; i < strings.size(); i++) {
+            auto found = table.find(strings[i]);
+
+            REQUIRE(found.has_value());
+            REQUIRE(*found <= i);
+            REQUIRE(table[*found] == strings[i]);
+        }
+
+        auto missing = basic_string<E> {u8"not in the table é\U0001F600"_s};
+        REQUIRE_FALSE(table.find(missing).has_value());
+    }
+
+    SECTION("checks") {
+        auto check = GENERATE(string_table_check::header, string_table_check::checksum, string_table_check::full);
+        REQUIRE(std::ranges::equal(string_table<E> {bytes, check}, strings, std::equal_to<> {}));
+    }
+}
+
+TEST_CASE("String table from other encodings", "[string_table]") {
+    auto strings = table_strings<unicode::utf8>(100);
+    auto views = std::vector<utf8_string_view> {strings.begin(), strings.end()};
+
+    auto from_strings = write_string_table<unicode::utf16le>(strings);
+    auto from_views = write_string_table<unicode::utf16le>(views);
+    auto from_column = write_string_table<unicode::utf16le>(string_column<unicode::utf8> {views}.transcode<unicode::utf16le>());
+
+    REQUIRE(from_strings == from_views);
+    REQUIRE(from_strings == from_column);
+    REQUIRE(std::ranges::equal(string_table<unicode::utf16le> {from_strings}, strings, std::equal_to<> {}));
+}
+
+TEST_CASE("String table corruption", "[string_table]") {
+    auto strings = table_strings<unicode::utf8>(100);
+    auto bytes = write_string_table<unicode::utf8>(strings);
+    auto header_size = sizeof(unicode::detail::string_table_header);
+
+    SECTION("empty") {
+        auto empty = write_string_table<unicode::utf8>(std::vector<utf8_string> {});
+        auto table = string_table<unicode::utf8> {empty};
+
+        REQUIRE(table.empty());
+        REQUIRE(table.begin() == table.end());
+        REQUIRE_FALSE(table.find(u8""_s).has_value());
+        REQUIRE(string_table<unicode::utf8> {}.empty());
+    }
+
+    SECTION("other encoding") {
+        REQUIRE_THROWS_AS(string_table<unicode::utf16le> {bytes}, std::invalid_argument);
+    }
+
+    SECTION("truncated") {
+        auto truncated = std::span {bytes}.first(bytes.size() - 1);
+        REQUIRE_THROWS_AS(string_table<unicode::utf8> {truncated}, std::invalid_argument);
+        REQUIRE_THROWS_AS(string_table<unicode::utf8> {std::span {bytes}.first(header_size - 1)}, std::invalid_argument);
+    }
+
+    SECTION("magic") {
+        bytes[0] = std::byte {'X'};
+        REQUIRE_THROWS_AS(string_table<unicode::utf8> {bytes}, std::invalid_argument);
+    }
+
+    SECTION("code units") {
+        auto units = string_table<unicode::utf8> {bytes}.code_units();
+        auto position = static_cast<size_t>(reinterpret_cast<const std::byte*>(units.data() + units.size() / 2) - bytes.data());
+        bytes[position] = std::byte {0xFF};
+
+        REQUIRE_NOTHROW(string_table<unicode::utf8> {bytes, string_table_check::header});
+        REQUIRE_THROWS_AS((string_table<unicode::utf8> {bytes, string_table_check::checksum}), std::invalid_argument);
+    }
+
+    SECTION("invalid strings with a valid checksum") {
+        auto units = string_table<unicode::utf8> {bytes}.code_units();
+        auto position = static_cast<size_t>(reinterpret_cast<const std::byte*>(units.data() + units.size() / 2) - bytes.data());
+        bytes[position] = std::byte {0xFF};
+
+        auto header = unicode::detail::string_table_header {};
+        std::memcpy(&header, bytes.data(), header_size);
+        header.checksum = unicode::detail::string_table_checksum(bytes.data(), bytes.size());
+        std::memcpy(bytes.data(), &header, header_size);
+
+        REQUIRE_NOTHROW(string_table<unicode::utf8> {bytes, string_table_check::checksum});
+        REQUIRE_THROWS_AS((string_table<unicode::utf8> {bytes, string_table_check::full}), unicode::parse_error);
+    }
+}
+
+#if __has_include(<sys/mman.h>)
+
+TEST_CASE("String table memory mapping", "[string_table]") {
+    auto strings = table_strings<unicode::utf8>(1000);
+    auto bytes = write_string_table<unicode::utf8>(strings);
+    auto path = std::filesystem::temp_directory_path() / "cppunicode_string_table_test.bin";
+
+    {
+        auto file = std::ofstream {path, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    auto file = mapped_file {path.c_str()};
+    auto table = string_table<unicode::utf8> {file.bytes()};
+
+    REQUIRE(std::ranges::equal(table, strings, std::equal_to<> {}));
+    REQUIRE(table.find(strings[500]) == 500);
+
+    std::filesystem::remove(path);
+
+    REQUIRE_THROWS_AS(mapped_file {path.c_str()}, std::system_error);
+}
+
+#endif
@@ -7,6 +7,12 @@
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
 using namespace bigj;
 using unicode::error_code;
 using unicode::utf8;
@@ -80,3 +86,181 @@ TEST_CASE("String view validating constructors", "[string_view]") {
         REQUIRE_THROWS_AS((str = string_view {data.data(), data.data() + data.size()}), unicode::parse_error);
     }
 }
+
+TEST_CASE("String view hash", "[string_view]") {
+    auto hash = std::hash<string_view> {};
+
+    SECTION("reference values") {
+        auto text = std::string_view {"Nobody inspects the spammish repetition"};
+        auto sv = string_view {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+
+        auto utf32 = std::vector<uint8_t> {};
+
+        for (auto c : text) {
+            utf32.insert(utf32.end(), {static_cast<uint8_t>(c), 0, 0, 0});
+        }
+
+        CHECK(hash(string_view {}) == static_cast<size_t>(0xEF46DB3751D8E999));
+        CHECK(hash(sv) == static_cast<size_t>(unicode::detail::hash_bytes(utf32.data(), utf32.size())));
+    }
+
+    SECTION("equal contents") {
+        auto length = GENERATE(range<size_t>(1, 100));
+        auto data = GENERATE_COPY(take(10, random_string<unicode::utf8>(length)));
+        auto copy = data;
+
+        auto sv_1 = string_view {data.data(), data.data() + data.size()};
+        auto sv_2 = string_view {copy.data(), copy.data() + copy.size()};
+
+        REQUIRE(hash(sv_1) == hash(sv_2));
+    }
+}
+
+template<unicode::encoding E>
+static auto check_search(const std::vector<typename E::code_unit>& data) -> void {
+    auto repeated = data;
+    repeated.insert(repeated.end(), data.begin(), data.end());
+
+    auto sv = basic_string_view<E> {repeated.data(), repeated.data() + repeated.size()};
+    auto half = basic_string_view<E> {data.data(), data.data() + data.size()};
+
+    for (auto it = half.begin(); it != half.end(); it++) {
+        for (auto jt = it; jt != half.end(); jt++) {
+            auto needle = half.substring(it, std::next(jt));
+            auto expected = std::ranges::search(sv.code_points(), needle.code_points());
+            auto expected_last = std::ranges::find_end(sv.code_points(), needle.code_points());
+
+            REQUIRE(sv.find(needle) == expected.begin());
+            REQUIRE(sv.rfind(needle) == expected_last.begin());
+            REQUIRE(sv.contains(needle));
+            auto units = needle.code_units();
+            auto prefix = std::ranges::equal(units, std::views::take(sv.code_units(), units.size()));
+            auto suffix = std::ranges::equal(units, std::views::drop(sv.code_units(), repeated.size() - units.size()));
+
+            REQUIRE(sv.starts_with(needle) == prefix);
+            REQUIRE(sv.ends_with(needle) == suffix);
+        }
+    }
+}
+
+TEST_CASE("String view search", "[string_view]") {
+    SECTION("random") {
+        auto length = GENERATE(range<size_t>(1, 30));
+
+        check_search<unicode::utf8>(GENERATE_COPY(take(3, random_string<unicode::utf8>(length))));
+        check_search<unicode::utf16be>(GENERATE_COPY(take(3, random_string<unicode::utf16be>(length))));
+        check_search<unicode::utf16le>(GENERATE_COPY(take(3, random_string<unicode::utf16le>(length))));
+        check_search<unicode::utf32le>(GENERATE_COPY(take(3, random_string<unicode::utf32le>(length))));
+    }
+
+    SECTION("repetitive") {
+        auto text = std::string(100, 'a') + "ab" + std::string(100, 'a');
+        auto data = reinterpret_cast<const uint8_t*>(text.data());
+        auto sv = string_view {data, data + text.size()};
+
+        auto find = [&](std::string_view needle) {
+            auto bytes = reinterpret_cast<const uint8_t*>(needle.data());
+            auto result = sv.find(string_view {bytes, bytes + needle.size()});
+            return result == sv.end() && !needle.empty() ? std::string::npos : result.address() - data;
+        };
+
+        auto rfind = [&](std::string_view needle) {
+            auto bytes = reinterpret_cast<const uint8_t*>(needle.data());
+            auto result = sv.rfind(string_view {bytes, bytes + needle.size()});
+            return result == sv.end() && !needle.empty() ? std::string::npos : result.address() - data;
+        };
+
+        for (auto needle : {"ab", "aab", "aba", "a", "b", "abb", "", "aaaaaaaaaaaaab"}) {
+            CHECK(find(needle) == text.find(needle));
+            CHECK(rfind(needle) == text.rfind(needle));
+        }
+    }
+
+    SECTION("boundaries") {
+        // U+0100 and U+0080 share their second code unit in UTF-8.
+        auto data = std::vector<uint8_t> {0xC4, 0x80, 0xC2, 0x80};
+        auto needle = std::vector<uint8_t> {0xC2, 0x80};
+        auto sv = string_view {data.data(), data.data() + data.size()};
+
+        CHECK(sv.find(string_view {needle.data(), needle.data() + 2}).address() == data.data() + 2);
+        CHECK(sv.contains(string_view {}));
+        CHECK(string_view {}.find(string_view {}) == string_view {}.begin());
+        CHECK(string_view {}.contains(string_view {}));
+        CHECK(!string_view {}.contains(string_view {needle.data(), needle.data() + 2}));
+    }
+}
+
+template<unicode::encoding E>
+static auto check_code_point_search(const std::vector<typename E::code_unit>& data) -> void {
+    auto sv = basic_string_view<E> {data.data(), data.data() + data.size()};
+
+    for (auto it = sv.begin(); it != sv.end(); it++) {
+        auto cp = *it;
+        auto last = it;
+
+        for (auto jt = it; jt != sv.end(); jt++) {
+            if (*jt == cp) last = jt;
+        }
+
+        REQUIRE(sv.find(cp) == std::ranges::find(sv, cp));
+        REQUIRE(sv.rfind(cp) == last);
+        REQUIRE(sv.count(cp) == static_cast<size_t>(std::ranges::count(sv, cp)));
+        REQUIRE(sv.contains(cp));
+    }
+}
+
+TEST_CASE("String view code point search", "[string_view]") {
+    SECTION("random") {
+        auto length = GENERATE(range<size_t>(1, 50));
+
+        check_code_point_search<unicode::utf8>(GENERATE_COPY(take(5, random_string<unicode::utf8>(length))));
+        check_code_point_search<unicode::utf16be>(GENERATE_COPY(take(5, random_string<unicode::utf16be>(length))));
+        check_code_point_search<unicode::utf32le>(GENERATE_COPY(take(5, random_string<unicode::utf32le>(length))));
+    }
+
+    SECTION("lines") {
+        auto text = std::string {};
+
+        for (int i = 0; i < 100; i++) {
+            text += std::string(i % 7, 'x') + "\n";
+        }
+
+        auto data = reinterpret_cast<const uint8_t*>(text.data());
+        auto sv = string_view {data, data + text.size()};
+
+        CHECK(sv.count(U'\n') == 100);
+        CHECK(sv.find(U'\n').address() == data);
+        CHECK(sv.rfind(U'\n').address() == data + text.size() - 1);
+        CHECK(sv.count(U'y') == 0);
+        CHECK(sv.find(U'y') == sv.end());
+    }
+
+    SECTION("invalid code points") {
+        auto data = std::vector<uint8_t> {0xED, 0x9F, 0xBF};
+        auto sv = string_view {data.data(), data.data() + data.size()};
+
+        CHECK(sv.contains(0xD7FF));
+        CHECK(!sv.contains(0xD800));
+        CHECK(sv.find(0x110000) == sv.end());
+        CHECK(sv.count(0xDFFF) == 0);
+    }
+}
+
+TEST_CASE("String view block decoding", "[string_view]") {
+    auto length = GENERATE(range<size_t>(0, 200));
+    auto data = GENERATE_COPY(take(5, random_string<unicode::utf16le>(length)));
+    auto block_size = GENERATE(size_t {1}, size_t {7}, size_t {64});
+
+    auto sv = utf16le_string_view {data.data(), data.data() + data.size()};
+    auto buffer = std::vector<unicode::code_point>(block_size);
+    auto decoded = std::vector<unicode::code_point> {};
+
+    for (auto block : sv.decode_blocks(buffer)) {
+        REQUIRE(!block.empty());
+        REQUIRE(block.size() <= block_size);
+        decoded.insert(decoded.end(), block.begin(), block.end());
+    }
+
+    REQUIRE(std::ranges::equal(decoded, sv.code_points()));
+    REQUIRE_THROWS_AS(sv.decode_blocks({}), std::invalid_argument);
+}
@@ -0,0 +1,130 @@
+#include "detail/random_string_generator.hpp"
+
+#include <bigj/literals.hpp>
+#include <bigj/string.hpp>
+#include <bigj/string_view.hpp>
+#include <bigj/transcode.hpp>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_adapters.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+using namespace bigj;
+using namespace bigj::literals;
+
+template<unicode::encoding E, unicode::encoding F>
+static auto expected_units(basic_string_view<F> sv) -> std::vector<typename E::code_unit> {
+    auto str = basic_string<E> {sv};
+    auto units = str.code_units();
+    return {units.begin(), units.end()};
+}
+
+template<typename R>
+static auto collect(R&& range) {
+    auto result = std::vector<std::ranges::range_value_t<R>> {};
+
+    for (auto unit : range) {
+        result.push_back(unit);
+    }
+
+    return result;
+}
+
+template<typename E, typename T>
+static auto copy_in_chunks(T& view, size_t chunk) -> std::vector<typename E::code_unit> {
+    auto result = std::vector<typename E::code_unit> {};
+    auto buffer = std::vector<typename E::code_unit>(chunk);
+
+    while (true) {
+        auto written = view.copy_to(buffer);
+        if (written.empty()) break;
+        result.insert(result.end(), written.begin(), written.end());
+    }
+
+    return result;
+}
+
+TEMPLATE_TEST_CASE(
+    "Transcode view",
+    "[transcode]",
+    (std::tuple<unicode::utf8, unicode::utf16le>),
+    (std::tuple<unicode::utf8, unicode::utf32be>),
+    (std::tuple<unicode::utf8, unicode::utf8>),
+    (std::tuple<unicode::utf16be, unicode::utf8>),
+    (std::tuple<unicode::utf16be, unicode::utf16le>),
+    (std::tuple<unicode::utf16le, unicode::utf32le>),
+    (std::tuple<unicode::utf32le, unicode::utf8>),
+    (std::tuple<unicode::utf32le, unicode::utf32be>),
+    (std::tuple<unicode::utf32be, unicode::utf16be>)
+) {
+    using F = std::tuple_element_t<0, TestType>;
+    using E = std::tuple_element_t<1, TestType>;
+
+    static_assert(std::ranges::input_range<transcode_view<E, F>>);
+    static_assert(std::ranges::view<transcode_view<E, F>>);
+
+    auto length = GENERATE(range<size_t>(0, 200, 7));
+    auto data = GENERATE_COPY(take(10, random_string<F>(length)));
+
+    // Mostly ASCII with a few wider code points, to go through the fast paths.
+    auto mixed = basic_string<F> {};
+
+    for (size_t i = 0; i < length; i++) {
+        auto cp = i % 13 == 12 ? U'€' : i % 29 == 28 ? U'\U0001F600' : static_cast<char32_t>(U'a' + i % 26);
+        mixed.push_back(cp);
+    }
+
+    auto sv = GENERATE(0, 1) == 0
+        ? basic_string_view<F> {data.data(), data.data() + data.size()}
+        : basic_string_view<F> {mixed};
+
+    auto expected = expected_units<E>(sv);
+
+    SECTION("iteration") {
+        CHECK(collect(views::transcode<E>(sv)) == expected);
+        CHECK(collect(sv | views::transcode<E>) == expected);
+    }
+
+    SECTION("size") {
+        auto view = views::transcode<E>(sv);
+        CHECK(view.encoded_size() == expected.size());
+
+        auto it = view.begin();
+        for (size_t i = 0; i < expected.size() / 2; i++) it++;
+        CHECK(view.encoded_size() == expected.size() - expected.size() / 2);
+    }
+
+    SECTION("copy") {
+        for (auto chunk : {1, 2, 3, 5, 64, 1000}) {
+            auto view = views::transcode<E>(sv);
+            CHECK(copy_in_chunks<E>(view, chunk) == expected);
+        }
+    }
+
+    SECTION("iteration followed by copy") {
+        auto view = views::transcode<E>(sv);
+        auto result = std::vector<typename E::code_unit> {};
+        auto it = view.begin();
+
+        for (size_t i = 0; i < expected.size() / 3; i++, it++) {
+            result.push_back(*it);
+        }
+
+        auto rest = copy_in_chunks<E>(view, 7);
+        result.insert(result.end(), rest.begin(), rest.end());
+        CHECK(result == expected);
+    }
+}
+
+TEST_CASE("Transcode view from string", "[transcode]") {
+    auto str = u8"aé€\U0001F600"_u16le;
+    auto units = collect(str | views::transcode<unicode::utf8>);
+
+    CHECK(units == std::vector<uint8_t> {'a', 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80});
+}